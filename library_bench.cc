@@ -0,0 +1,115 @@
+// Benchmarks for the BigInt types and bulk ModInt operations.  Prints one
+// tab-separated line per measurement (type, operation, operand digits or
+// span length, ns/op, and the scaling exponent against the previous size),
+// so runs can be diffed or plotted.
+//
+// Usage: library_bench.exe [max digits] [min seconds per measurement]
+
+double bench_min_time = 0.2;
+
+// Measures f, repeating it until bench_min_time has passed, in ns/op.
+template<typename F> double TimeOp(F f) {
+  for (int reps = 1; ; reps *= 2) {
+    clock_t start = clock();
+    for (int i = 0; i < reps; i++) f();
+    double secs = double(clock() - start) / CLOCKS_PER_SEC;
+    if (secs >= bench_min_time) return secs * 1e9 / reps;
+  }
+}
+
+string RandomDigits(int n) {
+  string ret(n, '0');
+  for (int i = 0; i < n; i++) ret[i] = '0' + rand()%10;
+  if (ret[0] == '0') ret[0] = '1';
+  return ret;
+}
+
+struct BenchResult {
+  double ns, scaling;
+  int digits;
+};
+map<string, BenchResult> last_result;
+size_t bench_sink;
+
+// Sizes at which an operation is predicted to take longer than this (from
+// its last time and scaling) are skipped.
+const double BENCH_MAX_NS = 5e9;
+
+template<typename F> void Report(const string& type, const string& op, int digits, F f) {
+  string key = type + "\t" + op;
+  bool seen = last_result.count(key);
+  BenchResult& last = last_result[key];
+  if (seen && last.ns * pow(double(digits) / last.digits, max(last.scaling, 1.0)) > BENCH_MAX_NS) return;
+  double ns = TimeOp(f);
+  printf("%s\t%d\t%.1f\t", key.c_str(), digits, ns);
+  if (seen) {
+    last.scaling = log(ns / last.ns) / log(double(digits) / last.digits);
+    printf("%.2f\n", last.scaling);
+  } else {
+    last.scaling = 2;
+    printf("-\n");
+  }
+  fflush(stdout);
+  last.ns = ns;
+  last.digits = digits;
+}
+
+// Decimal conversions, whatever the type's radix.
+SimpleBigInt Parse(const SimpleBigInt&, const string& s) {return SimpleBigInt(s);}
+string ToDecimal(const SimpleBigInt& a) {return a.tostring();}
+template<int R, int CR, int CS, class CT>
+BigInt<R,CR,CS,CT> Parse(const BigInt<R,CR,CS,CT>&, const string& s) {return BigInt<R,CR,CS,CT>(s, 10);}
+template<int R, int CR, int CS, class CT>
+string ToDecimal(const BigInt<R,CR,CS,CT>& a) {return a.tostring(10);}
+
+template<typename T> void BenchType(const string& type, int digits) {
+  string sa = RandomDigits(digits), sb = RandomDigits(digits), sx = RandomDigits(2*digits);
+  T a = Parse(T(), sa), b = Parse(T(), sb), x = Parse(T(), sx), c;
+  if (ToDecimal(a) != sa) {fprintf(stderr, "%s: bad round trip\n", type.c_str()); exit(1);}
+  Report(type, "add", digits, [&]() {c = a + b; bench_sink += (c < a);});
+  Report(type, "mul", digits, [&]() {c = a * b; bench_sink += (c < a);});
+  Report(type, "div", digits, [&]() {c = x / b; bench_sink += (c < a);});
+  Report(type, "mod", digits, [&]() {c = x % b; bench_sink += (c < a);});
+  Report(type, "tostring", digits, [&]() {bench_sink += ToDecimal(a).size();});
+  Report(type, "parse", digits, [&]() {c = Parse(T(), sa); bench_sink += (c < a);});
+}
+
+// ModIntSpan kernels against the equivalent loops over ModInt operators.
+// The loops are timed only once, at the highest level.
+template<int MOD> void BenchModIntSpan(int n, bool loops) {
+  typedef ModInt<MOD> M;
+  typedef ModIntSpan<MOD> S;
+  vector<M> a(n), b(n), r(n);
+  for (int i = 0; i < n; i++) a[i] = M(rand()), b[i] = M(rand());
+  M c(rand());
+  if (loops) {
+    Report("ModInt", "add", n, [&]() {for (int i = 0; i < n; i++) r[i] = a[i] + b[i]; bench_sink += r[n-1].value;});
+    Report("ModInt", "mul", n, [&]() {for (int i = 0; i < n; i++) r[i] = a[i] * b[i]; bench_sink += r[n-1].value;});
+    Report("ModInt", "muladd", n, [&]() {for (int i = 0; i < n; i++) r[i] += b[i] * c; bench_sink += r[n-1].value;});
+    Report("ModInt", "dot", n, [&]() {M d; for (int i = 0; i < n; i++) d += a[i] * b[i]; bench_sink += d.value;});
+  }
+  string type = "ModIntSpan" + to_string(S::Level());
+  Report(type, "add", n, [&]() {S::Add(&r[0], &a[0], &b[0], n); bench_sink += r[n-1].value;});
+  Report(type, "mul", n, [&]() {S::Mul(&r[0], &a[0], &b[0], n); bench_sink += r[n-1].value;});
+  Report(type, "muladd", n, [&]() {S::MulAdd(&r[0], &r[0], &b[0], c, n); bench_sink += r[n-1].value;});
+  Report(type, "dot", n, [&]() {bench_sink += S::Dot(&a[0], &b[0], n).value;});
+}
+
+int main(int argc, char** argv) {
+  int max_digits = (argc > 1) ? atoi(argv[1]) : 1000000;
+  if (argc > 2) bench_min_time = atof(argv[2]);
+  srand(1);
+  printf("# type\top\tdigits\tns/op\tscaling\n");
+  for (int digits = 10; digits <= max_digits; digits *= 10) {
+    BenchType<bigint>("bigint", digits);
+    BenchType<binarybigint>("binarybigint", digits);
+    BenchType<hexbigint>("hexbigint", digits);
+    BenchType<SimpleBigInt>("SimpleBigInt", digits);
+  }
+  int top = ModIntSpan<1000000007>::Level();
+  for (int level = top; level >= 0; level--) {
+    ModIntSpan<1000000007>::Level() = level;
+    for (int n = 1000; n <= 1000000; n *= 10) BenchModIntSpan<1000000007>(n, level == top);
+  }
+  return bench_sink == 12345;
+}
@@ -283,9 +283,739 @@ void TEST_BigInt() {
   }
 }
 
+template<int R, int CR, int CS, class CT>
+BigInt<R,CR,CS,CT> RandomBigInt(const BigInt<R,CR,CS,CT>&, int nchunks) {
+  BigInt<R,CR,CS,CT> ret;
+  for (int i = 0; i < nchunks; i++) ret.ch.push_back((uint64)Rand64()%CR);
+  if (nchunks) ret.ch.back() = max(ret.ch.back(), (CT)1);
+  ret.neg = rand()%2;
+  ret.trim();
+  return ret;
+}
+
+template<typename T> void TestBigIntMult(const string& name) {
+  int sizes[] = {1, 5, 31, 32, 33, 64, 100, 159, 160, 161, 300, 487, 1000, 2500};
+  int nsizes = sizeof(sizes)/sizeof(int);
+  for (int i = 0; i < nsizes; i++)
+  for (int j = 0; j <= i; j++) {
+    T a = RandomBigInt(T(), sizes[i]), b = RandomBigInt(T(), sizes[j]);
+    T c = a*b, d;
+    d.ch.resize(a.ch.size() + b.ch.size());
+    T::MulSchool(&d.ch[0], &a.ch[0], a.ch.size(), &b.ch[0], b.ch.size());
+    d.neg = a.neg ^ b.neg;
+    d.trim();
+    if (c != d) fail_test("BigIntMult", name + " mult mismatch");
+    if (b*a != c) fail_test("BigIntMult", name + " mult not commutative");
+  }
+  for (int i = 0; i < 3; i++) {
+    T a = RandomBigInt(T(), 4000 + rand()%3000), b = RandomBigInt(T(), 3000 + rand()%3000);
+    T c = a*b, d;
+    d.ch.resize(a.ch.size() + b.ch.size());
+    T::MulSchool(&d.ch[0], &a.ch[0], a.ch.size(), &b.ch[0], b.ch.size());
+    d.neg = a.neg ^ b.neg;
+    d.trim();
+    if (c != d) fail_test("BigIntMult", name + " NTT mult mismatch");
+    T sq = a;
+    sq *= sq;
+    if (sq != a*T(a)) fail_test("BigIntMult", name + " NTT square mismatch");
+  }
+  T a = RandomBigInt(T(), 700);
+  T sq = a*a, b = a;
+  b.ch.back() = 0; b.trim();  // Exercises leading zeros in the split halves.
+  if ((a-b)*(a+b) != sq - b*b) fail_test("BigIntMult", name + " identity");
+}
+
+template<typename T> void CheckBigIntDiv(const T& a, const T& b, const string& name) {
+  T q = a/b, r = a%b;
+  if (q*b + r != a) fail_test("BigIntDiv", name + " a != q*b+r");
+  if (abs(r) >= abs(b)) fail_test("BigIntDiv", name + " remainder too large");
+  if (!r.zero() && r.neg != a.neg) fail_test("BigIntDiv", name + " remainder sign");
+}
+
+template<typename T> void TestBigIntDiv(const string& name) {
+  int sizes[] = {1, 2, 5, 47, 48, 49, 96, 100, 200, 487, 1000, 2500};
+  int nsizes = sizeof(sizes)/sizeof(int);
+  for (int i = 0; i < nsizes; i++)
+  for (int j = 0; j <= i; j++) {
+    T a = RandomBigInt(T(), sizes[i]), b = RandomBigInt(T(), sizes[j]);
+    CheckBigIntDiv(a, b, name);
+    CheckBigIntDiv(a*b + b/T(3), b, name);
+    CheckBigIntDiv(b, a, name);
+  }
+  // Divisors with many top chunks equal exercise the quotient corrections.
+  T b = RandomBigInt(T(), 300), a = RandomBigInt(T(), 700);
+  for (int i = 150; i < 300; i++) b.ch[i] = b.ch.back();
+  for (int i = 400; i < 700; i++) a.ch[i] = b.ch[i-400];
+  CheckBigIntDiv(a, b, name);
+  CheckBigIntDiv(a*b - T(1), b, name);
+  // Quotient much shorter than the divisor.
+  a = RandomBigInt(T(), 3000);
+  b = RandomBigInt(T(), 2980);
+  CheckBigIntDiv(a, b, name);
+}
+
+void TEST_BigIntDiv() {
+  cerr << "  Running TEST_BigIntDiv()..." << endl;
+  TestBigIntDiv<bigint>("bigint");
+  TestBigIntDiv<binarybigint>("binarybigint");
+  TestBigIntDiv<hexbigint>("hexbigint");
+  TestBigIntDiv<BigInt<10, 10, 1, int> >("single-digit bigint");
+  TestBigIntDiv<BigInt<10> >("char bigint");
+  // Large enough for the Newton reciprocal.
+  bigint a = RandomBigInt(bigint(), 61000), b = RandomBigInt(bigint(), 30500);
+  CheckBigIntDiv(a, b, "bigint Newton");
+}
+
+void TEST_BigIntRadix() {
+  cerr << "  Running TEST_BigIntRadix()..." << endl;
+  if (binarybigint("-fF", 16).toint() != -255) fail_test("BigIntRadix", "hex parse");
+  if (bigint(-255).tostring(16) != "-FF") fail_test("BigIntRadix", "hex print");
+  if (bigint("zz", 36).tostring(7) != "3530") fail_test("BigIntRadix", "radix 36/7");
+  if (hexbigint(0).tostring(10) != "0") fail_test("BigIntRadix", "zero print");
+  int sizes[] = {0, 1, 2, 31, 33, 100, 1000, 5000};
+  for (int i = 0; i < sizeof(sizes)/sizeof(int); i++) {
+    bigint a = RandomBigInt(bigint(), sizes[i]);
+    binarybigint b(a);
+    hexbigint h(b);
+    BigInt<10> c(h);
+    string s = a.tostring();
+    if (bigint(b) != a || bigint(h) != a) fail_test("BigIntRadix", "round trip");
+    if (c.tostring() != s) fail_test("BigIntRadix", "char bigint conversion");
+    if (b.tostring(10) != s || h.tostring(10) != s) fail_test("BigIntRadix", "decimal print");
+    if (binarybigint(s, 10) != b || hexbigint(s, 10) != h) fail_test("BigIntRadix", "decimal parse");
+    if (a.tostring(2) != b.tostring() || a.tostring(16) != h.tostring()) fail_test("BigIntRadix", "binary/hex print");
+    if (bigint(h.tostring(), 16) != a) fail_test("BigIntRadix", "hex parse");
+    if (bigint(a.tostring(36), 36) != a) fail_test("BigIntRadix", "radix 36 round trip");
+  }
+}
+
+template<typename T> void TestBigIntInPlace(const string& name) {
+  for (int it = 0; it < 200; it++) {
+    T a = RandomBigInt(T(), rand()%40), b = RandomBigInt(T(), rand()%40);
+    if (it%5 == 0) b = -a;
+    int64 x = rand()%2000000 - 1000000, y = rand()%2000000 - 1000000;
+    T sum = a+b, diff = a-b, prod = a*b, r;
+    if (T(x)+T(y) != T(x+y) || T(x)-T(y) != T(x-y)) fail_test("BigIntInPlace", name + " small add/sub");
+    if (diff+b != a || sum-b != a || (a+b)-b != a) fail_test("BigIntInPlace", name + " add/sub inverse");
+    T::Add(a, b, r);
+    if (r != sum) fail_test("BigIntInPlace", name + " Add");
+    T::Sub(a, b, r);
+    if (r != diff) fail_test("BigIntInPlace", name + " Sub");
+    T::Mul(a, b, r);
+    if (r != prod) fail_test("BigIntInPlace", name + " Mul");
+    r = a; T::Add(r, b, r);
+    if (r != sum) fail_test("BigIntInPlace", name + " aliased Add");
+    r = b; T::Sub(a, r, r);
+    if (r != diff) fail_test("BigIntInPlace", name + " aliased Sub");
+    r = b; T::Mul(a, r, r);
+    if (r != prod) fail_test("BigIntInPlace", name + " aliased Mul");
+    r = sum; T::AddMul(r, a, b);
+    if (r != sum+prod) fail_test("BigIntInPlace", name + " AddMul");
+    r = sum; T::SubMul(r, a, b);
+    if (r != sum-prod || (r.zero() && r.neg)) fail_test("BigIntInPlace", name + " SubMul");
+    r = a; T::SubMul(r, r, b);
+    if (r != a-prod) fail_test("BigIntInPlace", name + " aliased SubMul");
+    r = diff; T::AddMulSmall(r, a, x);
+    if (r != diff + a*T(x)) fail_test("BigIntInPlace", name + " AddMulSmall");
+    r = a; T::AddMulSmall(r, r, -1);
+    if (!r.zero() || r.neg) fail_test("BigIntInPlace", name + " aliased AddMulSmall");
+    r = a; r += r;
+    if (r != a*T(2)) fail_test("BigIntInPlace", name + " a += a");
+    r = a; r -= r;
+    if (!r.zero() || r.neg) fail_test("BigIntInPlace", name + " a -= a");
+    if ((-T()).neg) fail_test("BigIntInPlace", name + " negative zero");
+  }
+}
+
+void TEST_BigIntInPlace() {
+  cerr << "  Running TEST_BigIntInPlace()..." << endl;
+  TestBigIntInPlace<bigint>("bigint");
+  TestBigIntInPlace<binarybigint>("binarybigint");
+  TestBigIntInPlace<BigInt<10> >("char bigint");
+}
+
+template<typename T> void TestBigIntModPow(const string& name) {
+  T p = T(1), one(1);
+  for (int i = 0; i < 127; i++) p *= 2;
+  p -= one;  // A Mersenne prime.
+  for (int i = 0; i < 20; i++) {
+    T a = RandomBigInt(T(), 20) % p;
+    if (!a.zero() && ModPow(a, p-one, p) != one) fail_test("BigIntModPow", name + " Fermat");
+  }
+  for (int i = 0; i < 100; i++) {
+    T a = RandomBigInt(T(), rand()%30), m = RandomBigInt(T(), 1 + rand()%20);
+    if (i%2 && m.ch[0]%2) m += one;  // Even moduli skip the Montgomery path.
+    int64 e = rand()%200;
+    T want = one%m;
+    for (int j = 0; j < e; j++) want = want*a%m;
+    if (want.neg) want += abs(m);
+    if (ModPow(a, T(e), m) != want) fail_test("BigIntModPow", name + " small exponents");
+    T e1 = RandomBigInt(abs(a), 5), e2 = RandomBigInt(abs(a), 3);
+    if (e1.neg) e1 = -e1;
+    if (e2.neg) e2 = -e2;
+    if (ModPow(a, e1+e2, m) != ModPow(a, e1, m)*ModPow(a, e2, m)%abs(m)) fail_test("BigIntModPow", name + " exponent sum");
+  }
+}
+
+void TEST_BigIntModPow() {
+  cerr << "  Running TEST_BigIntModPow()..." << endl;
+  TestBigIntModPow<bigint>("bigint");
+  TestBigIntModPow<binarybigint>("binarybigint");
+  TestBigIntModPow<hexbigint>("hexbigint");
+}
+
+template<typename T> void TestBigIntGcd(const string& name) {
+  int sizes[] = {0, 1, 2, 5, 40, 149, 150, 400, 1000};
+  int nsizes = sizeof(sizes)/sizeof(int);
+  for (int i = 0; i < nsizes; i++)
+  for (int j = 0; j < nsizes; j++) {
+    T g = RandomBigInt(T(), sizes[j]/2 + 1), a = RandomBigInt(T(), sizes[i]), b = RandomBigInt(T(), sizes[j]);
+    if (rand()%2) {a *= g; b *= g;}
+    T x = a, y = b, u, v;
+    while (!y.zero()) {x %= y; swap(x, y);}
+    x = abs(x);
+    if (Gcd(a, b) != x) fail_test("BigIntGcd", name + " Gcd");
+    if (ExtendedGcd(a, b, u, v) != x || a*u + b*v != x) fail_test("BigIntGcd", name + " ExtendedGcd");
+    if (!x.zero() && !b.zero() && abs(u) > abs(b)/x) fail_test("BigIntGcd", name + " ExtendedGcd bound");
+  }
+}
+
+void TEST_BigIntGcd() {
+  cerr << "  Running TEST_BigIntGcd()..." << endl;
+  TestBigIntGcd<bigint>("bigint");
+  TestBigIntGcd<binarybigint>("binarybigint");
+  TestBigIntGcd<BigInt<10> >("char bigint");
+  Fract<bigint> h;
+  for (int i = 1; i <= 20; i++) h += Fract<bigint>(1, i);
+  if (h != Fract<bigint>(55835135, 15519504)) fail_test("BigIntGcd", "Fract<bigint>");
+}
+
+template<typename T> void TestBigIntRoot(const string& name) {
+  int sizes[] = {1, 2, 3, 10, 100, 1000};
+  int ks[] = {1, 2, 3, 5, 7, 30, 1000};
+  for (int i = 0; i < sizeof(sizes)/sizeof(int); i++)
+  for (int j = 0; j < sizeof(ks)/sizeof(int); j++) {
+    T a = abs(RandomBigInt(T(), sizes[i])), r = Root(a, ks[j]);
+    if (r.Pow(ks[j]) > a || (r+T(1)).Pow(ks[j]) <= a) fail_test("BigIntRoot", name + " Root");
+    if (ks[j]%2 && Root(-a, ks[j]) != -r) fail_test("BigIntRoot", name + " negative Root");
+  }
+  T a = abs(RandomBigInt(T(), 300)), r = Sqrt(a*a), s;
+  if (r != a || Sqrt(a*a - T(1)) != a - T(1)) fail_test("BigIntRoot", name + " Sqrt");
+  int k = 0;
+  a = abs(RandomBigInt(T(), 20)) + T(2);
+  if (!IsPerfectPower(a.Pow(6), &s, &k) || s.Pow(k) != a.Pow(6) || k%6) fail_test("BigIntRoot", name + " IsPerfectPower");
+  if (IsPerfectPower(a.Pow(5) + T(1)) || IsPerfectPower(-a*a)) fail_test("BigIntRoot", name + " not IsPerfectPower");
+  if (!IsPerfectPower(-a.Pow(6), &s, &k) || s.Pow(k) != -a.Pow(6) || k%3) fail_test("BigIntRoot", name + " negative IsPerfectPower");
+  if (!IsPerfectPower(T(1024), &s, &k) || s != T(2) || k != 10) fail_test("BigIntRoot", name + " 2^10");
+  for (int b = 2; b <= 7; b++)
+  for (int e = 2; e <= 40; e++) {
+    a = T(b).Pow(e);
+    if (!IsPerfectPower(a, &s, &k) || s.Pow(k) != a || k%e) fail_test("BigIntRoot", name + " small powers");
+  }
+}
+
+void TEST_BigIntRoot() {
+  cerr << "  Running TEST_BigIntRoot()..." << endl;
+  TestBigIntRoot<bigint>("bigint");
+  TestBigIntRoot<binarybigint>("binarybigint");
+  TestBigIntRoot<hexbigint>("hexbigint");
+  TestBigIntRoot<BigInt<10> >("char bigint");
+}
+
+template<typename T> void TestBigIntBitwise(const string& name) {
+  int sizes[] = {0, 1, 2, 5, 100};
+  int shifts[] = {0, 1, 27, 28, 29, 30, 31, 100, 1000};
+  for (int i = 0; i < sizeof(sizes)/sizeof(int); i++)
+  for (int j = 0; j < sizeof(shifts)/sizeof(int); j++) {
+    T a = RandomBigInt(T(), sizes[i]), b = abs(RandomBigInt(T(), sizes[(i+j)%5])), p = T(2).Pow(shifts[j]);
+    if ((a << shifts[j]) != a*p || (a >> shifts[j]) != a/p || (a << -shifts[j]) != a/p) fail_test("BigIntBitwise", name + " shifts");
+    a = abs(a);
+    if ((a & b) + (a | b) != a + b || (a ^ b) != (a | b) - (a & b)) fail_test("BigIntBitwise", name + " and/or/xor");
+    if (((a | p) & p) != p || (a ^ a) != T() || a.test_bit(shifts[j]) != !(a/p%T(2)).zero()) fail_test("BigIntBitwise", name + " test_bit");
+    T m = p - T(1);
+    if (m.popcount() != shifts[j] || m.bit_length() != shifts[j] || p.bit_length() != shifts[j]+1) fail_test("BigIntBitwise", name + " bit_length");
+    if (p.trailing_zeros() != shifts[j] || (b*p).trailing_zeros() != (b.zero() ? -1 : b.trailing_zeros() + shifts[j])) fail_test("BigIntBitwise", name + " trailing_zeros");
+  }
+  if (T(-5) >> 1 != T(-2) || (T(-6) & T(-3)) != T(-2) || (T(-6) ^ T(6)).neg) fail_test("BigIntBitwise", name + " signs");
+}
+
+void TEST_BigIntBitwise() {
+  cerr << "  Running TEST_BigIntBitwise()..." << endl;
+  TestBigIntBitwise<binarybigint>("binarybigint");
+  TestBigIntBitwise<hexbigint>("hexbigint");
+}
+
+template<typename T> void TestBigIntSerialize(const string& name) {
+  int sizes[] = {0, 1, 3, 4, 5, 1000};
+  vector<T> v;
+  ostringstream out;
+  for (int i = 0; i < sizeof(sizes)/sizeof(int); i++) {
+    v.push_back(RandomBigInt(T(), sizes[i]));
+    v.back().Save(out);
+  }
+  string s = out.str();
+  istringstream in(s);
+  size_t pos = 0;
+  for (int i = 0; i < v.size(); i++) {
+    typename T::View w(s.data() + pos);
+    pos += w.bytes();
+    if (T::Load(in) != v[i] || !in || w.value() != v[i]) fail_test("BigIntSerialize", name + " round trip");
+  }
+  T::Load(in);
+  if (pos != s.size() || in) fail_test("BigIntSerialize", name + " end of stream");
+}
+
+void TEST_BigIntSerialize() {
+  cerr << "  Running TEST_BigIntSerialize()..." << endl;
+  TestBigIntSerialize<bigint>("bigint");
+  TestBigIntSerialize<binarybigint>("binarybigint");
+  TestBigIntSerialize<BigInt<10> >("char bigint");
+  ostringstream out;
+  bigint(12345).Save(out);
+  istringstream in(out.str());
+  binarybigint::Load(in);
+  if (in || binarybigint::View(out.str().data()).ch) fail_test("BigIntSerialize", "radix mismatch");
+  // Same radix, different chunk type.
+  ostringstream out2;
+  BigInt<10>(12345).Save(out2);
+  istringstream in2(out2.str());
+  BigInt<10, 10, 1, int>::Load(in2);
+  if (in2 || BigInt<10, 10, 1, int>::View(out2.str().data()).ch) fail_test("BigIntSerialize", "chunk type mismatch");
+  // A corrupt chunk count must fail at the end of the stream, not allocate it.
+  string s = out.str();
+  *(int64*)&s[0] = 1LL << 28;
+  istringstream in3(s);
+  bigint::Load(in3);
+  if (in3) fail_test("BigIntSerialize", "corrupt chunk count");
+}
+
+// Checks M (MontModInt<MOD> or DynModInt set to MOD) against ModInt<MOD>.
+template<int MOD, typename M> void TestModIntVariant(const string& name) {
+  for (int i = 0; i < 1000; i++) {
+    long long x = (long long)rand()*rand() - (long long)rand()*rand(), y = rand() - rand();
+    M a(x), b(y);
+    ModInt<MOD> p(x), q(y);
+    if (a.toint() != p.toint() || M(y).toint() != q.toint()) fail_test("ModInt", name + " conversion");
+    if ((a+b).toint() != (p+q).toint() || (a-b).toint() != (p-q).toint() || (-a).toint() != (-p).toint())
+      fail_test("ModInt", name + " add/sub");
+    if ((a*b).toint() != (p*q).toint() || a.Pow(i).toint() != p.Pow(i).toint()) fail_test("ModInt", name + " mul");
+    if (b != M() && (a/b*b != a || b.Inverse()*b != M(1))) fail_test("ModInt", name + " division");
+  }
+}
+
+template<int MOD> void TestModInt(const string& name) {
+  TestModIntVariant<MOD, MontModInt<MOD> >("MontModInt " + name);
+  DynModInt<>::SetMod(MOD);
+  TestModIntVariant<MOD, DynModInt<> >("DynModInt " + name);
+}
+
+void TEST_ModInt() {
+  cerr << "  Running TEST_ModInt()..." << endl;
+  TestModInt<1000000007>("1000000007");
+  TestModInt<998244353>("998244353");
+  TestModInt<(1<<30)-35>("2^30-35");
+  TestModInt<3>("3");
+  if (MontModInt<1>(5).toint() || ModInt<7>(-3).toint() != 4) fail_test("ModInt", "small moduli");
+  MontModInt<999999999> c(1000);  // Composite modulus, 3^4 * 37 * 333667.
+  if ((c * c.Inverse()).toint() != 1 || (MontModInt<999999999>(7) / c * c).toint() != 7)
+    fail_test("ModInt", "MontModInt composite modulus");
+  typedef DynModInt<1> D;
+  D::SetMod(2147483646);  // Composite, and as large as allowed.
+  DynModInt<>::SetMod(7);
+  D a(-1), b(12345679);
+  if ((a*a).toint() != 1 || (a+a).toint() != 2147483644 || (b*b.Inverse()).toint() != 1 || DynModInt<>(-1).toint() != 6)
+    fail_test("ModInt", "DynModInt large composite modulus");
+}
+
+// Checks the span kernels at every ISA level against scalar ModInt ops.
+template<int MOD> void TestModIntSpan(const string& name) {
+  typedef ModInt<MOD> M;
+  typedef ModIntSpan<MOD> S;
+  int top = S::Level();
+  for (int level = top; level >= 0; level--) {
+    S::Level() = level;
+    for (int n = 0; n < 40; n += 3) {
+      vector<M> a(n+1), b(n+1), r(n+1);
+      for (int i = 0; i < n; i++) {
+        a[i] = M((long long)rand()*rand() - (long long)rand()*rand());
+        b[i] = (i%5 == 0) ? M(MOD-1) : M(rand() - rand());
+      }
+      M c(rand() - rand()), dot;
+      for (int i = 0; i < n; i++) dot += a[i] * b[i];
+      string where = name + " level " + to_string(level);
+      S::Add(&r[0], &a[0], &b[0], n);
+      for (int i = 0; i < n; i++) if (r[i].value != (a[i]+b[i]).toint()) fail_test("ModIntSpan", where + " Add");
+      S::Sub(&r[0], &a[0], &b[0], n);
+      for (int i = 0; i < n; i++) if (r[i].value != (a[i]-b[i]).toint()) fail_test("ModIntSpan", where + " Sub");
+      S::Mul(&r[0], &a[0], &b[0], n);
+      for (int i = 0; i < n; i++) if (r[i].value != (a[i]*b[i]).toint()) fail_test("ModIntSpan", where + " Mul");
+      S::Scale(&r[0], &a[0], c, n);
+      for (int i = 0; i < n; i++) if (r[i].value != (a[i]*c).toint()) fail_test("ModIntSpan", where + " Scale");
+      if (S::Dot(&a[0], &b[0], n).toint() != dot.toint()) fail_test("ModIntSpan", where + " Dot");
+      r = a;
+      S::MulAdd(&r[0], &r[0], &b[0], c, n);
+      for (int i = 0; i < n; i++) if (r[i].value != (a[i]+b[i]*c).toint()) fail_test("ModIntSpan", where + " MulAdd");
+      if (r[n].value) fail_test("ModIntSpan", where + " overrun");
+      S::Inverse(&r[0], &a[0], n);
+      for (int i = 0; i < n; i++)
+        if (a[i].toint() ? (r[i]*a[i]).toint() != 1 : r[i].value) fail_test("ModIntSpan", where + " Inverse");
+    }
+  }
+  S::Level() = top;
+}
+
+void TEST_ModIntSpan() {
+  cerr << "  Running TEST_ModIntSpan()..." << endl;
+  TestModIntSpan<1000000007>("1000000007");
+  TestModIntSpan<998244353>("998244353");
+  TestModIntSpan<(1<<30)-35>("2^30-35");
+  TestModIntSpan<3>("3");
+}
+
+// Checks Binomial<MOD> against Pascal's triangle mod MOD.
+template<int MOD> void TestBinomial(int maxn) {
+  typedef ModInt<MOD> M;
+  vector<M> row(1, M(1));
+  for (int n = 0; n <= maxn; n++) {
+    for (int k = -1; k <= n+1; k++) {
+      M expect = (k >= 0 && k <= n) ? row[k] : M();
+      if (Binomial<MOD>::C(n, k) != expect) fail_test("Binomial", "C(" + to_string(n) + ", " + to_string(k) + ")");
+    }
+    vector<M> next(n+2, M(1));
+    for (int k = 1; k <= n; k++) next[k] = row[k-1] + row[k];
+    row = next;
+  }
+}
+
+void TEST_Binomial() {
+  cerr << "  Running TEST_Binomial()..." << endl;
+  TestBinomial<1000000007>(300);
+  TestBinomial<7>(400);
+  TestBinomial<2>(100);
+  typedef Binomial<998244353> B;
+  ModInt<998244353> sum;
+  for (int k = 0; k <= 1000000; k++) sum += B::C(1000000, k);
+  if (sum != ModInt<998244353>(2).Pow(1000000)) fail_test("Binomial", "row sum");
+  if (B::P(10, 3).toint() != 720 || B::Factorial(20) != ModInt<998244353>(2432902008176640000LL) ||
+      (B::Factorial(12345) * B::InvFactorial(12345)).toint() != 1)
+    fail_test("Binomial", "factorials");
+  // Lucas (values from Python).
+  if (Binomial<10007>::C(1000000000000000000LL, 1000000).toint() != 2410 || Binomial<13>::C(169, 13).toint() ||
+      Binomial<13>::C(5, 6).toint())
+    fail_test("Binomial", "Lucas");
+  if (Binomial<7>::Factorial(6).toint() != 6 || Binomial<7>::Factorial(7).toint() || Binomial<7>::Factorial(100).toint())
+    fail_test("Binomial", "factorials >= MOD");
+}
+
+void TEST_ModInv() {
+  cerr << "  Running TEST_ModInv()..." << endl;
+  unsigned mods[] = {1, 2, 3, 1000000007, 4294967291u, 4294967295u, 1u<<31, 360360};
+  for (int t = 0; t < sizeof(mods)/sizeof(unsigned); t++) {
+    unsigned m = mods[t];
+    vector<unsigned> a, r;
+    for (int i = 0; i < 1000; i++) {
+      unsigned x = (unsigned)rand()*7919 + rand();
+      if (i%100 == 0) x = m*(i/100);
+      if (Gcd<int64>(x%m, m) == 1 || x%m == 0) a.push_back(x);
+    }
+    for (int i = 0; i < a.size(); i++) {
+      unsigned inv = ModInv(a[i], m);
+      if (a[i]%m && ModMult(inv, a[i], m) != 1%m) fail_test("ModInv", "single, mod " + to_string(m));
+    }
+    r = a;
+    ModInvBatch(&r[0], &r[0], r.size(), m);
+    for (int i = 0; i < a.size(); i++)
+      if (r[i] != (a[i]%m ? ModInv(a[i], m) : 0)) fail_test("ModInv", "batch, mod " + to_string(m));
+  }
+  if (ModInt<12>(5).Inverse().toint() != 5 || (ModInt<1000000007>(3) / ModInt<1000000007>(-3)).toint() != 1000000006)
+    fail_test("ModInv", "ModInt");
+}
+
+template<int MOD> void TestConvolve(const string& name, int maxn) {
+  typedef ModInt<MOD> M;
+  for (int t = 0; t < 30; t++) {
+    int na = rand()%maxn + 1, nb = (t%3 == 0) ? na : rand()%maxn + 1;
+    vector<M> a(na), b(nb), expect(na+nb-1);
+    for (int i = 0; i < na; i++) a[i] = (t%5 == 0) ? M(-1) : M(rand() - rand());
+    for (int i = 0; i < nb; i++) b[i] = (t%5 == 0) ? M(MOD-1) : M(rand() - rand());
+    for (int i = 0; i < na; i++)
+    for (int j = 0; j < nb; j++)
+      expect[i+j] += a[i] * b[j];
+    vector<M> got = Convolve(a, b);
+    if (got.size() != expect.size()) fail_test("Convolve", name + " size");
+    for (int i = 0; i < got.size(); i++) if (got[i] != expect[i]) fail_test("Convolve", name + " value");
+  }
+}
+
+void TEST_Convolve() {
+  cerr << "  Running TEST_Convolve()..." << endl;
+  // Transform() against the DFT by definition.
+  typedef NTT<998244353, 3> N;
+  for (int n = 1; n <= 64; n *= 2) {
+    vector<unsigned> a(n), f(n);
+    for (int i = 0; i < n; i++) a[i] = rand();
+    unsigned w = ModPow(3, (998244353-1)/n, 998244353);
+    for (int k = 0; k < n; k++)
+    for (int i = 0; i < n; i++)
+      f[k] = (f[k] + (uint64)a[i] % 998244353 * ModPow(w, (uint64)i*k, 998244353)) % 998244353;
+    vector<unsigned> b = a;
+    for (int i = 0; i < n; i++) b[i] %= 998244353;
+    N::Transform(&b[0], n, false);
+    if (b != f) fail_test("Convolve", "NTT forward, n = " + to_string(n));
+    N::Transform(&b[0], n, true);
+    for (int i = 0; i < n; i++) if (b[i] != a[i] % 998244353) fail_test("Convolve", "NTT inverse, n = " + to_string(n));
+  }
+  TestConvolve<998244353>("998244353", 600);
+  TestConvolve<1000000007>("1000000007", 600);
+  TestConvolve<(1<<30)-35>("2^30-35", 3000);
+  TestConvolve<3>("3", 100);
+  if (Convolve(vector<ModInt<7> >(), vector<ModInt<7> >(5, 1)).size()) fail_test("Convolve", "empty");
+  vector<ModInt<1000000007> > co(100, ModInt<1000000007>(1));
+  Polynomial<ModInt<1000000007> > p(co), sq = p*p;
+  if (sq.co.size() != 199 || sq.co[99].toint() != 100 || sq.co[198].toint() != 1) fail_test("Convolve", "Polynomial");
+  // Threads growing their twiddle tables at the same time.
+  vector<vector<ModInt<1000000007> > > prods(4);
+  vector<thread> pool;
+  for (int i = 0; i < 4; i++) pool.push_back(thread([&, i]() {
+    for (int n = 64; n <= (1<<15); n *= 2) prods[i] = Convolve(vector<ModInt<1000000007> >(n, i+1), co);
+  }));
+  for (int i = 0; i < 4; i++) pool[i].join();
+  for (int i = 0; i < 4; i++)
+    if (prods[i].size() != (1<<15)+99 || prods[i][99].toint() != 100*(i+1) || prods[i].back().toint() != i+1)
+      fail_test("Convolve", "threads");
+}
+
+void TEST_ModMult64() {
+  cerr << "  Running TEST_ModMult64()..." << endl;
+  uint64 mods[] = {1, 3, 1000000007, (1ULL<<61)-1, ~0ULL, ~0ULL-58, 0};
+  for (int t = 0; t < 200; t++) {
+    uint64 m = mods[t%7] ? mods[t%7] : ((uint64)Rand64() | 1);
+    Montgomery64 mont(m);
+    for (int i = 0; i < 100; i++) {
+      uint64 a = Rand64(), b = Rand64(), e = (uint64)Rand64() >> (i%64);
+      uint64 hi, lo;
+      Mult128(a, b, hi, lo);
+      // Reference by shift-and-subtract.
+      uint64 ref = 0;
+      for (int bit = 127; bit >= 0; bit--) {
+        bool car = ref>>63;
+        ref <<= 1;
+        ref |= (bit >= 64 ? hi>>(bit-64) : lo>>bit) & 1;
+        if (car || ref >= m) ref -= m;
+      }
+      if (ModMult64(a, b, m) != ref) fail_test("ModMult64", "ModMult64");
+      if (mont.From(mont.Mul(mont.To(a), mont.To(b))) != ref) fail_test("ModMult64", "Montgomery64 Mul");
+      if (mont.From(mont.Pow(mont.To(a), e)) != ModPow64(a, e, m)) fail_test("ModMult64", "Montgomery64 Pow");
+    }
+  }
+  if (ModPow64(2, 64, ~0ULL) != 1 || ModPow64(3, 0, 1) != 0) fail_test("ModMult64", "ModPow64");
+}
+
+void CheckPrimeFactors64(uint64 n) {
+  vector<uint64> f = PrimeFactors64(n);
+  uint64 prod = 1;
+  for (int i = 0; i < f.size(); i++) {
+    if (!IsPrimeFast64(f[i]) || (i && f[i] < f[i-1])) fail_test("PrimeFactors64", "bad factor of " + to_string(n));
+    prod *= f[i];
+  }
+  if (prod != n) fail_test("PrimeFactors64", "product of factors of " + to_string(n));
+}
+
+void TEST_PrimeFactors64() {
+  cerr << "  Running TEST_PrimeFactors64()..." << endl;
+  for (int n = 1; n < 20000; n++) {
+    vector<int> f = PrimeFactors(n);
+    vector<uint64> g = PrimeFactors64(n);
+    if (vector<uint64>(f.begin(), f.end()) != g) fail_test("PrimeFactors64", "small n = " + to_string(n));
+    if (EulerPhi64(n) != EulerPhi(n)) fail_test("PrimeFactors64", "EulerPhi64");
+  }
+  uint64 hard[] = {~0ULL, 4294967291ULL*4294967279ULL, 4294967291ULL*4294967291ULL, 1000000007ULL*1000000007ULL,
+                   2147483647ULL*2147483647ULL*3, 18446744073709551557ULL, 1ULL<<63, 3825123056546413051ULL,
+                   999999999999999989ULL, 131ULL*131*131*131*131*131*131*131};
+  for (int i = 0; i < sizeof(hard)/sizeof(uint64); i++) CheckPrimeFactors64(hard[i]);
+  if (PrimeFactors64(~0ULL).size() != 7 || EulerPhi64(4294967291ULL*4294967279ULL) != 4294967290ULL*4294967278ULL)
+    fail_test("PrimeFactors64", "known values");
+  for (int i = 0; i < 2000; i++) CheckPrimeFactors64(Rand64());
+  // Semiprimes with two ~31-bit factors are the slow case for rho.
+  for (int i = 0; i < 50; i++) {
+    uint64 p = (uint64)rand() | 1, q = (uint64)rand() | 1;
+    while (!IsPrimeFast64(p)) p += 2;
+    while (!IsPrimeFast64(q)) q += 2;
+    CheckPrimeFactors64(p*q);
+  }
+}
+
+void TEST_WheelSieve() {
+  cerr << "  Running TEST_WheelSieve()..." << endl;
+  PrimeSieve(3000000);
+  WheelSieve sieve(3000000);
+  vector<uint64> got, expect;
+  sieve.ForEach(0, 3000000, [&](uint64 p) {got.push_back(p);});
+  for (int i = 0; i < 3000000; i++) if (prime[i]) expect.push_back(i);
+  if (got != expect) fail_test("WheelSieve", "ForEach over [0, 3e6)");
+  for (int t = 0; t < 200; t++) {
+    uint64 lo = rand()%3000000, hi = lo + rand()%(t < 100 ? 100 : 3000000);
+    hi = min(hi, (uint64)3000000);
+    uint64 n = upper_bound(expect.begin(), expect.end(), hi-1) - lower_bound(expect.begin(), expect.end(), lo);
+    if (sieve.Count(lo, hi) != n) fail_test("WheelSieve", "Count(" + to_string(lo) + ", " + to_string(hi) + ")");
+  }
+  // A window far above the sieving primes' own range.
+  uint64 lo = 1000000000000ULL - 54321, hi = lo + 200000;
+  WheelSieve big(hi);
+  got.clear(); expect.clear();
+  big.ForEach(lo, hi, [&](uint64 p) {got.push_back(p);});
+  for (uint64 x = lo; x < hi; x++) if (IsPrimeFast64(x)) expect.push_back(x);
+  if (got != expect || big.Count(lo, hi) != expect.size()) fail_test("WheelSieve", "window near 1e12");
+  if (WheelSieve(1000000000).Count(0, 1000000000) != 50847534) fail_test("WheelSieve", "pi(1e9)");
+  // Threads must not change the results or their order.
+  for (int threads = 0; threads <= 4; threads += 2) {
+    vector<uint64> par;
+    big.ForEach(lo - 30000000, hi, [&](uint64 p) {par.push_back(p);}, threads);
+    if (par.size() != big.Count(lo - 30000000, hi) || !is_sorted(par.begin(), par.end()) ||
+        !equal(expect.begin(), expect.end(), par.end() - expect.size()))
+      fail_test("WheelSieve", "parallel ForEach, threads = " + to_string(threads));
+    if (big.Count(lo - 30000000, hi, threads) != par.size()) fail_test("WheelSieve", "parallel Count");
+  }
+}
+
+void TEST_LinearSieve() {
+  cerr << "  Running TEST_LinearSieve()..." << endl;
+  const int N = 100000;
+  LinearSieve sieve(N);
+  PrimeSieve(N);
+  vector<int> phi = sieve.EulerPhi(), mu = sieve.Mobius(), d = sieve.DivisorCount();
+  vector<int64> sigma = sieve.DivisorSum();
+  // 2^(number of distinct prime factors), through a user-supplied callback.
+  vector<int> sqfree = sieve.Multiplicative<int>([](int p, int e, int64 pe) {return 2;});
+  for (int n = 1; n <= N; n++) {
+    if (n >= 2 && (sieve.IsPrime(n) != prime[n] || sieve.Spf(n) != PrimeFactors(n)[0]))
+      fail_test("LinearSieve", "spf of " + to_string(n));
+    vector<pair<int, int> > f = sieve.Factor(n);
+    vector<int> u = UniquePrimeFactors(n);
+    if (f.size() != u.size()) fail_test("LinearSieve", "Factor(" + to_string(n) + ")");
+    int m = 1;
+    for (int i = 0; i < f.size(); i++) {
+      if (f[i].first != u[i]) fail_test("LinearSieve", "Factor(" + to_string(n) + ")");
+      for (int j = 0; j < f[i].second; j++) m *= f[i].first;
+    }
+    if (m != n) fail_test("LinearSieve", "Factor(" + to_string(n) + ") product");
+    if (phi[n] != EulerPhi(n) || sqfree[n] != (1 << u.size())) fail_test("LinearSieve", "phi");
+    int e = 0;
+    for (int i = 0; i < f.size(); i++) e = max(e, f[i].second);
+    if (mu[n] != (e > 1 ? 0 : (f.size()%2 ? -1 : 1))) fail_test("LinearSieve", "mobius");
+  }
+  for (int n = 1; n <= 2000; n++) {
+    int cnt = 0;
+    int64 sum = 0;
+    for (int k = 1; k <= n; k++) if (n%k == 0) {cnt++; sum += k;}
+    if (d[n] != cnt || sigma[n] != sum) fail_test("LinearSieve", "divisor count/sum of " + to_string(n));
+  }
+  if (LinearSieve(1).primes.size() || LinearSieve(2).primes.size() != 1 || LinearSieve(3).primes.size() != 2)
+    fail_test("LinearSieve", "tiny limits");
+}
+
+void TEST_PrimeCounter() {
+  cerr << "  Running TEST_PrimeCounter()..." << endl;
+  PrimeSieve(3000000);
+  PrimeCounter small(3000000), pc(1000000000000ULL);
+  for (int x = 0, n = 0; x < 3000000; x++) {
+    n += prime[x];
+    if ((x < 100000 || x%997 == 0) && (small.Count(x) != n || pc.Count(x) != n))
+      fail_test("PrimeCounter", "Count(" + to_string(x) + ")");
+  }
+  // Above the table, against a sieve.
+  vector<uint64> xs(30);
+  for (int i = 0; i < xs.size(); i++) xs[i] = (uint64)rand() * rand() % 3000000000ULL;
+  sort(xs.begin(), xs.end());
+  WheelSieve sieve(3000000000ULL);
+  uint64 n = 0;
+  for (int i = 0; i < xs.size(); i++) {
+    n += sieve.Count(i ? xs[i-1]+1 : 0, xs[i]+1);
+    if (pc.Count(xs[i]) != n) fail_test("PrimeCounter", "Count(" + to_string(xs[i]) + ")");
+  }
+  if (pc.Count(10000000000ULL) != 455052511 || pc.Count(100000000000ULL) != 4118054813ULL ||
+      pc.Count(1000000000000ULL) != 37607912018ULL || pc.Count(999999999999ULL) != 37607912018ULL)
+    fail_test("PrimeCounter", "known values");
+  if (PrimeCounter(0).Count(0) || PrimeCounter(1).Count(1) || PrimeCounter(2).Count(2) != 1)
+    fail_test("PrimeCounter", "tiny xmax");
+  // Counters sized for x itself, so x sits right at the top of the table.
+  uint64 sized[][2] = {{100000000, 5761455}, {300000000, 16252325}, {1000000000, 50847534}, {3000000000ULL, 144449537}};
+  for (int i = 0; i < 4; i++)
+    if (PrimeCounter(sized[i][0]).Count(sized[i][0]) != sized[i][1])
+      fail_test("PrimeCounter", "Count(" + to_string(sized[i][0]) + ") with xmax = x");
+  // One counter shared by several threads.
+  vector<uint64> got(4);
+  vector<thread> pool;
+  for (int i = 0; i < 4; i++) pool.push_back(thread([&, i]() {got[i] = pc.Count(xs[i*7] * 17);}));
+  for (int i = 0; i < 4; i++) pool[i].join();
+  for (int i = 0; i < 4; i++) if (got[i] != pc.Count(xs[i*7] * 17)) fail_test("PrimeCounter", "threads");
+}
+
+void TEST_SmallVector() {
+  cerr << "  Running TEST_SmallVector()..." << endl;
+  SmallVector<int, 4> a, b;
+  vector<int> ref;
+  for (int i = 0; i < 100; i++) {
+    a.push_back(i); ref.push_back(i);
+    if (a.size() != ref.size() || !equal(a.begin(), a.end(), ref.begin())) fail_test("SmallVector", "push_back");
+  }
+  b.assign(ref.begin(), ref.begin()+3);
+  a.swap(b);
+  if (a.size() != 3 || b.size() != 100 || b.capacity() < 100 || a[2] != 2 || b[99] != 99) fail_test("SmallVector", "swap");
+  b.swap(a);
+  b.insert(b.begin()+1, ref.begin()+10, ref.begin()+12);
+  if (b.size() != 5 || b[1] != 10 || b[2] != 11 || b[3] != 1 || b.back() != 2) fail_test("SmallVector", "insert");
+  SmallVector<int, 4> c(move(a)), d(b);
+  if (c.size() != 100 || !a.empty() || d != b || c == d) fail_test("SmallVector", "copy/move");
+  c.resize(2); c.resize(4, 7);
+  if (c[1] != 1 || c[3] != 7 || *c.rbegin() != 7) fail_test("SmallVector", "resize");
+  // Inserting a range of the vector itself, with and without reallocation.
+  for (int sz = 1; sz <= 40; sz++) for (int cap = sz; cap <= 2*sz; cap += sz) {
+    SmallVector<int, 4> e;
+    e.reserve(cap);
+    for (int i = 0; i < sz; i++) e.push_back(i);
+    vector<int> r(e.begin(), e.end());
+    int i = rand()%sz, j = i + rand()%(sz-i+1), at = rand()%(sz+1);
+    e.insert(e.begin()+at, e.begin()+i, e.begin()+j);
+    r.insert(r.begin()+at, r.begin()+i, r.begin()+j);
+    if (e.size() != r.size() || !equal(e.begin(), e.end(), r.begin())) fail_test("SmallVector", "self insert");
+  }
+  static_assert(is_nothrow_move_constructible<bigint>::value && is_nothrow_move_assignable<bigint>::value,
+                "vector<bigint> must move on reallocation");
+}
+
+void TEST_BigIntMult() {
+  cerr << "  Running TEST_BigIntMult()..." << endl;
+  TestBigIntMult<bigint>("bigint");
+  TestBigIntMult<binarybigint>("binarybigint");
+  TestBigIntMult<hexbigint>("hexbigint");
+  TestBigIntMult<BigInt<10, 10, 1, int> >("single-digit bigint");
+  TestBigIntMult<BigInt<10> >("char bigint");
+}
+
 int main() {
   srand(time(0));
   TEST_PokerHand();
   TEST_IsPrimeFast();
   TEST_BigInt();
+  TEST_BigIntMult();
+  TEST_BigIntDiv();
+  TEST_BigIntRadix();
+  TEST_BigIntInPlace();
+  TEST_SmallVector();
+  TEST_BigIntModPow();
+  TEST_BigIntGcd();
+  TEST_BigIntRoot();
+  TEST_BigIntBitwise();
+  TEST_BigIntSerialize();
+  TEST_ModInt();
+  TEST_ModIntSpan();
+  TEST_Binomial();
+  TEST_ModInv();
+  TEST_Convolve();
+  TEST_ModMult64();
+  TEST_PrimeFactors64();
+  TEST_WheelSieve();
+  TEST_LinearSieve();
+  TEST_PrimeCounter();
 }
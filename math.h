@@ -18,8 +18,30 @@ unsigned ModPow(unsigned a, uint64 b, unsigned m) {
   }
 }
 
-inline unsigned ModInv(unsigned a, unsigned p) {  // Works for prime p only.
-  return ModPow(a, p-2, p);
+// Extended Euclid; requires gcd(a, m) == 1, but not that m is prime.
+unsigned ModInv(unsigned a, unsigned m) {
+  int64 s0 = 0, s1 = 1;
+  unsigned r0 = m, r1 = a % m;
+  while (r1) {
+    unsigned q = r0 / r1;
+    r0 -= q*r1; swap(r0, r1);
+    s0 -= q*s1; swap(s0, s1);
+  }
+  return (s0 < 0) ? s0 + m : s0;
+}
+
+// r[i] = a[i]^-1 mod m (0 where a[i] == 0 mod m), by Montgomery's trick:
+// one ModInv and 3n multiplications.  Nonzero a[i] must be coprime to m.
+// r may alias a.
+void ModInvBatch(unsigned* r, const unsigned* a, int n, unsigned m) {
+  vector<unsigned> pre(n+1, 1%m);
+  for (int i = 0; i < n; i++) pre[i+1] = (a[i]%m) ? ModMult(pre[i], a[i]%m, m) : pre[i];
+  unsigned inv = ModInv(pre[n], m);
+  for (int i = n-1; i >= 0; i--) {
+    unsigned x = a[i]%m;
+    r[i] = x ? ModMult(inv, pre[i], m) : 0;
+    if (x) inv = ModMult(inv, x, m);
+  }
 }
 
 inline uint64 ModMult48(uint64 a, uint64 b, uint64 m) {  // Requires m < 2^42.
@@ -43,6 +65,9 @@ inline uint64 ModInv48(uint64 a, uint64 p) {  // Requires prime p < 2^42.
 }
 
 inline uint64 ModMult64(uint64 a, uint64 b, uint64 m) {
+  #ifdef __SIZEOF_INT128__
+  return (unsigned __int128)a*b%m;
+  #else
   uint64 hi, lo;
   Mult128(a, b, hi, lo);
   for (int i = 0; i < 64; i++) {
@@ -52,6 +77,7 @@ inline uint64 ModMult64(uint64 a, uint64 b, uint64 m) {
     if (car || hi >= m) hi -= m;
   }
   return hi;
+  #endif
 }
 
 uint64 ModPow64(uint64 a, uint64 b, uint64 m) {
@@ -67,6 +93,35 @@ inline uint64 ModInv64(uint64 a, uint64 p) {  // Requires prime p.
   return ModPow64(a, p-2, p);
 }
 
+// Montgomery multiplication for a fixed odd modulus m < 2^64; values are
+// kept as x*2^64 mod m.  Cheaper than ModMult64 when m is reused, since it
+// needs no 128-bit division.
+struct Montgomery64 {
+  uint64 m, minv, r2;  // minv = m^-1 mod 2^64, r2 = 2^128 mod m.
+  explicit Montgomery64(uint64 m) : m(m), minv(m) {
+    for (int i = 0; i < 5; i++) minv *= 2 - m*minv;
+    r2 = ModMult64(-m%m, -m%m, m);
+  }
+  // a*b/2^64 mod m, for a*b < m*2^64.
+  uint64 Mul(uint64 a, uint64 b) const {
+    uint64 hi, lo, qhi, qlo;
+    Mult128(a, b, hi, lo);
+    Mult128(lo*minv, m, qhi, qlo);
+    return (hi >= qhi) ? hi-qhi : hi-qhi+m;
+  }
+  uint64 To(uint64 x) const {return Mul(x, r2);}
+  uint64 From(uint64 x) const {return Mul(x, 1);}
+  // Both a and the result are in Montgomery form.
+  uint64 Pow(uint64 a, uint64 b) const {
+    uint64 ret = To(1);
+    for(;;) {
+      if (b&1) ret = Mul(ret, a);
+      if (!(b>>=1)) return ret;
+      a = Mul(a, a);
+    }
+  }
+};
+
 //// *** Primality and Factoring ***
 
 template<typename T> T Gcd(const T& a, const T& b) {
@@ -85,6 +140,146 @@ void PrimeSieve(int limit) {
   }
 }
 
+// Segmented sieve of Eratosthenes for numbers below hi (practical to about
+// 10^15).  Only numbers coprime to 30 are stored, 8 to a byte: bit j of byte
+// k stands for 30k + Wheel(j).  Sieving runs in L1-sized blocks with memory
+// O(sqrt(hi)), and primes in [lo, hi) can be streamed without a full table.
+// ForEach() and Count() can also split the range across threads.
+struct WheelSieve {
+  #define WHEELSIEVE__BLOCK 32768
+  vector<unsigned> primes;  // Sieving primes, 7 <= p <= sqrt(hi).
+  explicit WheelSieve(uint64 hi) {
+    uint64 r = sqrt((double)hi);
+    while (r*r > hi) r--;
+    while ((r+1)*(r+1) <= hi) r++;
+    vector<bool> composite(r+1);
+    for (uint64 x = 2; x <= r; x++) if (!composite[x]) {
+      if (x >= 7) primes.push_back(x);
+      for (uint64 y = x*x; y <= r; y += x) composite[y] = true;
+    }
+  }
+  static int Wheel(int j) {static const int w[8] = {1, 7, 11, 13, 17, 19, 23, 29}; return w[j];}
+  static int WheelIndex(int r) {  // Inverse of Wheel().
+    static const char idx[30] = {0,0,0,0,0,0,0,1,0,0,0,2,0,3,0,0,0,4,0,5,0,0,0,6,0,0,0,0,0,7};
+    return idx[r];
+  }
+  // Sieves bytes [b0, b1) block by block, calling g(first byte, bits, count)
+  // for each; the bits are only valid during the call.  Each (prime, residue
+  // of the multiplier) pair walks its multiples with stride p bytes.
+  template<typename G> void Blocks(uint64 b0, uint64 b1, G g) const {
+    vector<uint64> next(8*primes.size());
+    vector<unsigned char> mask(8*primes.size()), bits(WHEELSIEVE__BLOCK);
+    for (size_t i = 0; i < primes.size(); i++) {
+      uint64 p = primes[i], m0 = max(p, (30*b0 + p-1) / p);
+      for (int j = 0; j < 8; j++) {
+        uint64 m = (m0 > Wheel(j)) ? (m0 - Wheel(j) + 29) / 30 * 30 + Wheel(j) : Wheel(j);
+        next[8*i+j] = p*m/30;
+        mask[8*i+j] = ~(1 << WheelIndex(p*m%30));
+      }
+    }
+    for (uint64 s = b0; s < b1; s += WHEELSIEVE__BLOCK) {
+      uint64 e = min(b1, s + WHEELSIEVE__BLOCK);
+      fill(bits.begin(), bits.begin() + (e-s), 0xff);
+      if (s == 0) bits[0] &= ~1;
+      for (size_t i = 0; i < primes.size() && (uint64)primes[i]*primes[i] < 30*e; i++) {
+        uint64 p = primes[i];
+        for (int j = 0; j < 8; j++) {
+          uint64 k = next[8*i+j];
+          for (unsigned char m = mask[8*i+j]; k < e; k += p) bits[k-s] &= m;
+          next[8*i+j] = k;
+        }
+      }
+      g(s, &bits[0], int(e-s));
+    }
+  }
+  // Runs work(i) for 0 <= i < n on a pool of 'threads' threads (0 for one
+  // per core), handing out indices in order.
+  template<typename W> static void Parallel(int n, int threads, W work) {
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    threads = min(threads, n);
+    atomic<int> next(0);
+    auto worker = [&]() {for (int i; (i = next++) < n; ) work(i);};
+    vector<thread> pool;
+    for (int t = 1; t < threads; t++) pool.push_back(thread(worker));
+    if (threads > 0) worker();
+    for (int t = 0; t < pool.size(); t++) pool[t].join();
+  }
+  // Calls f(p) for each prime lo <= p < hi, in increasing order.  With
+  // several threads (0 for one per core), a pool of workers sieves chunks
+  // into a ring of 2*threads buffers, and this thread passes their primes
+  // to f in order.
+  template<typename F> void ForEach(uint64 lo, uint64 hi, F f, int threads = 1) const {
+    #define WHEELSIEVE__CHUNK (1<<18)
+    for (int p = 2; p <= 5; p += p-1) if (lo <= p && p < hi) f((uint64)p);
+    uint64 b0 = lo/30, b1 = (hi+29)/30, chunks = (b1 - b0 + WHEELSIEVE__CHUNK-1) / WHEELSIEVE__CHUNK;
+    auto scan = [&](uint64 s, const unsigned char* bits, int n, vector<uint64>* out) {
+      for (int k = 0; k < n; k++)
+      for (unsigned b = bits[k]; b; b &= b-1) {
+        uint64 x = 30*(s+k) + Wheel(__builtin_ctz(b));
+        if (x >= lo && x < hi) {if (out) out->push_back(x); else f(x);}
+      }
+    };
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    if (threads == 1 || chunks <= 1) {
+      Blocks(b0, b1, [&](uint64 s, const unsigned char* bits, int n) {scan(s, bits, n, NULL);});
+      return;
+    }
+    // Chunk c goes in slot c % slots once free[slot] reaches c; filled[slot]
+    // becomes c+1 when its primes are ready.
+    int slots = 2*threads;
+    vector<vector<uint64> > found(slots);
+    vector<atomic<uint64> > free(slots), filled(slots);
+    for (int i = 0; i < slots; i++) free[i] = i, filled[i] = 0;
+    atomic<uint64> next(0);
+    auto worker = [&]() {
+      for (uint64 c; (c = next++) < chunks; ) {
+        int i = c % slots;
+        while (free[i] != c) this_thread::yield();
+        uint64 s = b0 + c*WHEELSIEVE__CHUNK;
+        Blocks(s, min(b1, s + WHEELSIEVE__CHUNK),
+               [&](uint64 s, const unsigned char* bits, int n) {scan(s, bits, n, &found[i]);});
+        filled[i] = c+1;
+      }
+    };
+    vector<thread> pool;
+    for (int t = 0; t < threads; t++) pool.push_back(thread(worker));
+    for (uint64 c = 0; c < chunks; c++) {
+      int i = c % slots;
+      while (filled[i] != c+1) this_thread::yield();
+      for (int j = 0; j < found[i].size(); j++) f(found[i][j]);
+      found[i].clear();
+      free[i] = c + slots;
+    }
+    for (int t = 0; t < threads; t++) pool[t].join();
+  }
+  // Number of primes lo <= p < hi, split over 'threads' threads (0 for one
+  // per core).  Each thread sieves one contiguous range, so it sets up its
+  // per-prime positions only once.
+  uint64 Count(uint64 lo, uint64 hi, int threads = 1) const {
+    uint64 small = 0;
+    for (int p = 2; p <= 5; p += p-1) small += (lo <= p && p < hi);
+    auto count = [&](uint64 b0, uint64 b1) {
+      uint64 ret = 0;
+      Blocks(b0, b1, [&](uint64 s, const unsigned char* bits, int n) {
+        for (int k = 0; k < n; k++) {
+          uint64 x = 30*(s+k);
+          if (x >= lo && x+30 <= hi) {ret += __builtin_popcount(bits[k]); continue;}
+          for (unsigned b = bits[k]; b; b &= b-1)
+            ret += (x + Wheel(__builtin_ctz(b)) >= lo && x + Wheel(__builtin_ctz(b)) < hi);
+        }
+      });
+      return ret;
+    };
+    uint64 b0 = lo/30, b1 = (hi+29)/30, chunks = (b1 - b0 + WHEELSIEVE__CHUNK-1) / WHEELSIEVE__CHUNK;
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    int parts = min<uint64>(threads, chunks);
+    if (parts <= 1) return small + count(b0, b1);
+    atomic<uint64> ret(small);
+    Parallel(parts, parts, [&](int t) {ret += count(b0 + (b1-b0)*t/parts, b0 + (b1-b0)*(t+1)/parts);});
+    return ret;
+  }
+};
+
 bool IsPrime(uint64 n) {
   if (n <= 3) return n > 1;
   if ((n&1) == 0 || n%3 == 0) return false;
@@ -169,14 +364,16 @@ bool IsPrimeFast64(uint64 n) {
        3825123056546413051LL, 3825123056546413051LL, 3825123056546413051LL, 0};
   uint64 s = n-1, r = 0;
   while (s%2 == 0) {s /= 2; r++;}
+  Montgomery64 mont(n);
+  uint64 one = mont.To(1), minus1 = mont.To(n-1);
   for (int i = 0, j; i < sizeof(millerrabin)/sizeof(uint64); i++) {
-    uint64 md = ModPow64(millerrabin[i], s, n);
-    if (md != 1) {
+    uint64 md = mont.Pow(mont.To(millerrabin[i]), s);
+    if (md != one) {
       for (j = 1; j < r; j++) {
-        if (md == n-1) break;
-        md = ModMult64(md, md, n);
+        if (md == minus1) break;
+        md = mont.Mul(md, md);
       }
-      if (md != n-1) return false;
+      if (md != minus1) return false;
     }
     if (n < A014233[i]) return true;
   }
@@ -225,6 +422,115 @@ int EulerPhi(int n) {
   return ret;
 }
 
+// Returns a nontrivial factor of n, which must be odd and composite.
+// Pollard's rho with Brent's cycle finding; gcds are batched over runs of
+// 128 steps and redone one at a time only if a run overshoots.
+uint64 PollardRho(uint64 n) {
+  #define POLLARDRHO__BATCH 128
+  Montgomery64 mont(n);
+  auto gcd = [](uint64 a, uint64 b) {while (a) {b %= a; swap(a, b);} return b;};
+  for (uint64 c0 = 1; ; c0++) {
+    uint64 c = mont.To(c0), x, y = mont.To(2), ys, q = mont.To(1), g = 1;
+    // y -> y^2 + c, in Montgomery form.
+    auto step = [&](uint64& y) {y = mont.Mul(y, y); y = (y >= n-c) ? y-(n-c) : y+c;};
+    for (uint64 r = 1; g == 1; r *= 2) {
+      x = y;
+      for (uint64 i = 0; i < r; i++) step(y);
+      for (uint64 k = 0; k < r && g == 1; k += POLLARDRHO__BATCH) {
+        ys = y;
+        for (uint64 i = 0; i < POLLARDRHO__BATCH && i < r-k; i++) {
+          step(y);
+          q = mont.Mul(q, (x > y) ? x-y : y-x);
+        }
+        g = gcd(q, n);
+      }
+    }
+    if (g == n) {
+      do {step(ys); g = gcd((x > ys) ? x-ys : ys-x, n);} while (g == 1);
+    }
+    if (g != n) return g;
+  }
+}
+
+// Prime factors of n in increasing order, with multiplicity.  Trial
+// division by small primes, then Pollard's rho; microseconds per number.
+vector<uint64> PrimeFactors64(uint64 n) {
+  vector<uint64> ret, todo;
+  for (uint64 x = 2; x < 128 && x*x <= n; x += 1 + (x > 2)) {
+    while (n%x == 0) {ret.push_back(x); n /= x;}
+  }
+  if (n > 1) todo.push_back(n);
+  while (todo.size()) {
+    n = todo.back(); todo.pop_back();
+    if (IsPrimeFast64(n)) {ret.push_back(n); continue;}
+    uint64 f = PollardRho(n);
+    todo.push_back(f); todo.push_back(n/f);
+  }
+  sort(ret.begin(), ret.end());
+  return ret;
+}
+
+uint64 EulerPhi64(uint64 n) {
+  vector<uint64> f = PrimeFactors64(n);
+  for (int i = 0; i < f.size(); i++) if (!i || f[i] != f[i-1]) n = n / f[i] * (f[i]-1);
+  return n;
+}
+
+// Linear (Euler) sieve up to limit: every composite is crossed off once, by
+// its smallest prime factor.  The table holds only odd n, as 16-bit values
+// (a composite's smallest factor is <= sqrt(limit) < 2^16; 0 means prime),
+// so it takes one byte per number.  Factor() is O(log n), and
+// Multiplicative() fills in any multiplicative function for all n <= limit.
+struct LinearSieve {
+  int limit;
+  vector<int> primes;
+  vector<unsigned short> spf;  // spf[n/2] for odd n.
+  explicit LinearSieve(int limit) : limit(limit), spf(max(limit, 0)/2 + 1) {
+    if (limit >= 2) primes.push_back(2);
+    for (int i = 3; i <= limit; i += 2) {
+      int lp = spf[i/2];
+      if (!lp) {lp = i; primes.push_back(i);}
+      for (int j = 1; j < primes.size() && primes[j] <= lp && (int64)primes[j]*i <= limit; j++)
+        spf[primes[j]*i/2] = primes[j];
+    }
+  }
+  // Smallest prime factor of n, for 2 <= n <= limit.
+  int Spf(int n) const {return (n%2 == 0) ? 2 : spf[n/2] ? spf[n/2] : n;}
+  bool IsPrime(int n) const {return n >= 2 && Spf(n) == n;}
+  // (prime, exponent) pairs of n, by increasing prime.
+  vector<pair<int, int> > Factor(int n) const {
+    vector<pair<int, int> > ret;
+    while (n > 1) {
+      int p = Spf(n), e = 0;
+      do {n /= p; e++;} while (n%p == 0);
+      ret.push_back(make_pair(p, e));
+    }
+    return ret;
+  }
+  // f[n] for 0 < n <= limit (f[0] = T()), where f is multiplicative and
+  // pp(p, e, p^e) gives its value at prime powers.  Each n reuses f of n
+  // with its smallest prime's power removed.
+  template<typename T, typename F> vector<T> Multiplicative(F pp) const {
+    vector<T> f(limit+1);
+    if (limit >= 1) f[1] = T(1);
+    for (int n = 2; n <= limit; n++) {
+      int p = Spf(n), m = n/p, e = 1;
+      int64 pe = p;
+      while (m%p == 0) {m /= p; e++; pe *= p;}
+      f[n] = f[m] * pp(p, e, pe);
+    }
+    return f;
+  }
+  vector<int> EulerPhi() const
+    {return Multiplicative<int>([](int p, int e, int64 pe) {return int(pe - pe/p);});}
+  vector<int> Mobius() const
+    {return Multiplicative<int>([](int p, int e, int64 pe) {return (e == 1) ? -1 : 0;});}
+  vector<int> DivisorCount() const
+    {return Multiplicative<int>([](int p, int e, int64 pe) {return e+1;});}
+  vector<int64> DivisorSum() const
+    {return Multiplicative<int64>([](int p, int e, int64 pe) {return (pe*p - 1) / (p-1);});}
+};
+
 // Lehmer's method for counting primes p, 2 <= p <= x.
 vector<int> cumprime, primelist(1);
 uint64 CountPrimes(uint64 x);
@@ -260,6 +566,182 @@ uint64 CountPrimes(uint64 x) {
   return ret;
 }
 
+// Counts primes <= x for any x <= xmax by the Lagarias-Miller-Odlyzko
+// method.  pi(x) = phi(x, a) + a - 1 - P2(x, a) with
+// a = pi(y), y = alpha*x^(1/3), and phi(x, a) is summed over the leaves of
+// its recursion: ordinary leaves n <= y from a table of phi(v, 7) over one
+// primorial period, special leaves phi(v, b) with v < p_{b+1}^2 straight from
+// the pi table, and the rest counted while sieving [0, z = x/y] one bitset
+// segment at a time.  The constructor tabulates pi up to max(z, sqrt(xmax))
+// (WheelSieve's bytes, with a running count per word) and the squarefree
+// m <= y free of the first 7 primes.  Count() allocates its own buffers and
+// modifies nothing, so one PrimeCounter can be shared by several threads.
+// Count() takes roughly O(x^(2/3)) time, and the pi table is about
+// xmax^(2/3)/alpha bits, alpha growing as log^3 xmax.
+struct PrimeCounter {
+  #define PRIMECOUNTER__C 7
+  #define PRIMECOUNTER__SEGMENT (1<<16)
+  uint64 xmax, limit;
+  // WheelSieve's bytes, eight to a word: bit 8k+j of bits[w] is
+  // 240w+30k+Wheel(j), and counts[w] = primes above 5 below 240w.
+  vector<uint64> bits;
+  vector<unsigned> counts;
+  uint64 below[240];            // below[r]: the bits of a word at offsets <= r.
+  vector<unsigned> primes;      // primes[i] is the i-th prime, through the first above sqrt(xmax).
+  vector<unsigned> phitab;      // phitab[v] = phi(v, C) for v < Q = p_1*...*p_C.
+  vector<uint64> wheel;         // Bit n: n is coprime to Q, for n < Q+64.
+  vector<pair<int, int> > leafm;  // Squarefree m <= y with lpf(m) > p_C, and mu(m)*lpf(m).
+  // The 48 residues coprime to 210, so the sieve only crosses off p*m for
+  // m free of 2, 3, 5 and 7: gap[j] leads from the j-th residue to the next,
+  // and m%210 = r is followed by residue number wheelidx[r], adv[r] later.
+  int gap[48], wheelidx[210], adv[210];
+  static uint64 FloorRoot(uint64 x, int k) {
+    uint64 r = pow((double)x, 1.0/k);
+    while (r > 0 && pow((double)r, k) > x) r--;
+    while (pow((double)(r+1), k) <= x) r++;
+    return r;
+  }
+  static uint64 Y(uint64 x) {
+    double l = log10((double)x), alpha = max(1.0, l*l*l/700);
+    return max<uint64>(1, min<uint64>(alpha * FloorRoot(x, 3), FloorRoot(x, 2)));
+  }
+  explicit PrimeCounter(uint64 xmax) : xmax(xmax), primes(1) {
+    limit = max(max(xmax / Y(xmax), FloorRoot(xmax, 2)) + 1, (uint64)1<<20);
+    bits.resize(limit/240 + 1);
+    counts.resize(bits.size() + 1);
+    WheelSieve(limit+1).Blocks(0, 8*bits.size(), [&](uint64 s, const unsigned char* b, int n) {
+      copy(b, b+n, (unsigned char*)&bits[0] + s);  // Little-endian.
+    });
+    for (int w = 0; w < bits.size(); w++) counts[w+1] = counts[w] + __builtin_popcountll(bits[w]);
+    for (int r = 0; r < 240; r++) {
+      below[r] = 0;
+      for (int i = 0; i < 64; i++) if (30*(i/8) + WheelSieve::Wheel(i%8) <= r) below[r] |= 1ULL << i;
+    }
+    primes.push_back(2); primes.push_back(3); primes.push_back(5);
+    for (int w = 0; primes.size() <= PRIMECOUNTER__C || (uint64)primes.back()*primes.back() <= xmax; w++)
+      for (uint64 b = bits[w]; b && (primes.size() <= PRIMECOUNTER__C || (uint64)primes.back()*primes.back() <= xmax); b &= b-1) {
+        int i = __builtin_ctzll(b);
+        primes.push_back(240*w + 30*(i/8) + WheelSieve::Wheel(i%8));
+      }
+    int q = 1;
+    for (int i = 1; i <= PRIMECOUNTER__C; i++) q *= primes[i];
+    phitab.resize(q);
+    wheel.resize((q+64)/64 + 1);
+    for (int v = 1; v < q+64; v++) {
+      bool coprime = true;
+      for (int i = 1; i <= PRIMECOUNTER__C; i++) coprime = coprime && v%primes[i];
+      if (v < q) phitab[v] = phitab[v-1] + coprime;
+      wheel[v/64] |= (uint64)coprime << (v%64);
+    }
+    vector<int> rs;
+    for (int r = 1; r < 210; r++) if (r%2 && r%3 && r%5 && r%7) rs.push_back(r);
+    for (int j = 0; j < 48; j++) gap[j] = (j < 47 ? rs[j+1] : rs[0]+210) - rs[j];
+    for (int r = 0, j = 0; r < 210; r++) {
+      while (rs[j] < r) j++;
+      wheelidx[r] = j;
+      adv[r] = rs[j] - r;
+    }
+    LinearSieve ls(Y(xmax));
+    vector<int> mu = ls.Mobius();
+    leafm.push_back(make_pair(1, 0x7fffffff));
+    for (int n = 2; n <= ls.limit; n++)
+      if (mu[n] && ls.Spf(n) > primes[PRIMECOUNTER__C]) leafm.push_back(make_pair(n, mu[n] * ls.Spf(n)));
+  }
+  // pi(x) for x <= limit, from the table.
+  uint64 Pi(uint64 x) const {
+    if (x < 5) return (x >= 2) + (x >= 3);
+    return 3 + counts[x/240] + __builtin_popcountll(bits[x/240] & below[x%240]);
+  }
+  // Numbers 1 <= n <= x with no prime factor among the first C primes.
+  uint64 PhiC(uint64 x) const {return x / phitab.size() * phitab.back() + phitab[x % phitab.size()];}
+  // Number of primes p <= x; requires x <= xmax.
+  uint64 Count(uint64 x) const {
+    assert(x <= xmax);
+    if (x <= limit) return Pi(x);
+    const int c = PRIMECOUNTER__C;
+    // Y() isn't quite monotone, so keep z = x/y below limit (y <= Y(xmax) still).
+    uint64 y = max(Y(x), x/limit + 1), z = x/y;
+    int a = Pi(y), b2 = Pi(FloorRoot(x, 2)), nm = upper_bound(leafm.begin(), leafm.end(), make_pair((int)y, 0x7fffffff)) - leafm.begin();
+    int64 sum = a - 1;
+    // Ordinary leaves.
+    for (int i = 0; i < nm; i++) sum += (leafm[i].second > 0 ? 1 : -1) * (int64)PhiC(x/leafm[i].first);
+    // Special leaves x/(p_b m) with y/p_b < m <= y and lpf(m) > p_b, each
+    // contributing -mu(m) phi(x/(p_b m), b-1).  Once p_b > sqrt(y), m must
+    // be a prime q, and if also v = x/(p_b q) < p_b^2 the leaf is easy:
+    // phi(v, b-1) = 1 + max(pi(v) - (b-1), 0).
+    int sqrty = Pi(FloorRoot(y, 2)), hard = min(a-1, (int)Pi(FloorRoot(x, 4)));
+    for (int b = max(c+1, sqrty+1); b < a; b++) {
+      uint64 p = primes[b];
+      // Past q = x/p^2, v < p_b and each leaf is just 1.
+      int start = max<int>(b+1, Pi(x/(p*p*p)) + 1), mid = min<uint64>(a, max<uint64>(start-1, Pi(x/(p*p))));
+      sum += a - mid;
+      for (int i = start, j; i <= mid; i = j+1) {
+        uint64 v = x/(p*primes[i]);
+        int t = Pi(v);
+        // Below q, runs of q share pi(v): all q <= x/(p p_t) do.
+        j = (v < primes[i]) ? min(mid, (int)Pi(x/(p*primes[t]))) : i;
+        sum += (j-i+1) * (1 + max(t-b+1, 0));
+      }
+    }
+    // The other (hard) leaves need p_b < x^(1/4), and are counted while
+    // sieving [0, z] by the first 'hard' primes.  phi[b] counts the numbers
+    // below the segment left after sieving by the first b-1 primes.  Within
+    // a segment, each prime's leaves are visited in increasing order of v,
+    // so one running popcount answers them all.
+    vector<int64> phi(hard+1);
+    vector<int> next(hard+1, nm-1);  // Per b, the largest leafm index still to visit.
+    vector<uint64> seg(PRIMECOUNTER__SEGMENT/64);
+    vector<int> blocks(PRIMECOUNTER__SEGMENT/512);  // Alive numbers per 512 bits.
+    for (uint64 low = 0; low <= z; low += PRIMECOUNTER__SEGMENT) {
+      uint64 high = min(low + PRIMECOUNTER__SEGMENT, z+1);
+      int len = high - low, words = (len+63)/64, alive = 0;
+      fill(blocks.begin(), blocks.end(), 0);
+      for (int w = 0, r = low % phitab.size(); w < words; w++, r = (r+64 >= phitab.size()) ? r+64-phitab.size() : r+64) {
+        seg[w] = (wheel[r/64] >> (r%64)) | (r%64 ? wheel[r/64+1] << (64 - r%64) : 0);
+        if (w == words-1 && len%64) seg[w] &= (1ULL << (len%64)) - 1;
+        blocks[w/8] += __builtin_popcountll(seg[w]);
+        alive += __builtin_popcountll(seg[w]);
+      }
+      for (int b = c+1; b <= hard; b++) {
+        uint64 p = primes[b];
+        // Leaves of larger primes are all below x/p^2; none are left here.
+        if (b > sqrty && low && p*p > x/low) break;
+        uint64 mlo = max(y/p, x/(p*high)), mhi = low ? min(y, x/(p*low)) : y;
+        int bl = 0, before = 0;  // Alive numbers in [0, 512bl) of the segment.
+        auto upto = [&](uint64 v) {  // Alive numbers in [low, v].
+          int i = v - low, ret;
+          for (; bl < i/512; bl++) before += blocks[bl];
+          ret = before + __builtin_popcountll(seg[i/64] & ((2ULL << (i%64)) - 1));
+          for (int w = 8*bl; w < i/64; w++) ret += __builtin_popcountll(seg[w]);
+          return ret;
+        };
+        if (b <= sqrty) {
+          int& k = next[b];
+          for (; k >= 0 && leafm[k].first > mhi; k--) ;
+          for (; k >= 0 && leafm[k].first > mlo; k--)
+            if (abs(leafm[k].second) > p)
+              sum -= (leafm[k].second > 0 ? 1 : -1) * (phi[b] + upto(x/(p*leafm[k].first)));
+        } else {
+          for (int i = min<uint64>(a, Pi(min(mhi, x/(p*p*p)))); i > b && primes[i] > mlo; i--)
+            sum += phi[b] + upto(x/(p*primes[i]));
+        }
+        phi[b] += alive;
+        uint64 m = (low + p-1) / p;
+        int j = wheelidx[m%210];
+        for (uint64 k = p*(m + adv[m%210]) - low; k < len; k += p*gap[j], j = (j == 47) ? 0 : j+1) {
+          int bit = (seg[k/64] >> (k%64)) & 1;
+          alive -= bit;
+          blocks[k/512] -= bit;
+          seg[k/64] &= ~(1ULL << (k%64));
+        }
+      }
+    }
+    // P2: numbers p*q <= x with y < p <= q primes.
+    for (int i = a+1; i <= b2; i++) sum -= Pi(x / primes[i]) - (i-1);
+    return sum;
+  }
+};
+
 //// *** Combinations/Permutations ***
 
 int Comb(int a, int b) {
@@ -273,9 +755,204 @@ int Comb(int a, int b) {
   return ret;
 }
 
+// Binomial coefficients modulo a prime MOD.  The factorial tables grow on
+// demand (doubling, with one modular inverse per growth), so C(n, k) is O(1)
+// amortized for n < MOD.  For n >= MOD, C() applies Lucas' theorem, which
+// needs tables up to MOD-1 and so suits small primes.
+template<int MOD> struct Binomial {
+  typedef ModInt<MOD> M;
+  static vector<M>& Fact() {static vector<M> f(1, M(1)); return f;}
+  static vector<M>& InvFact() {static vector<M> f(1, M(1)); return f;}
+  static void Grow(int n) {
+    vector<M> &f = Fact(), &finv = InvFact();
+    int old = f.size();
+    if (n < old) return;
+    n = min(max(n+1, 2*old), MOD);
+    f.resize(n);
+    finv.resize(n);
+    for (int i = old; i < n; i++) f[i] = f[i-1] * M(i);
+    finv[n-1] = f[n-1].Inverse();
+    for (int i = n-1; i > old; i--) finv[i-1] = finv[i] * M(i);
+  }
+  // n! is 0 for n >= MOD, which has no inverse.
+  static M Factorial(int n) {
+    if (n >= MOD) return M();
+    Grow(n);
+    return Fact()[n];
+  }
+  static M InvFactorial(int n) {
+    assert(n < MOD);
+    Grow(n);
+    return InvFact()[n];
+  }
+  static M C(long long n, long long k) {
+    if (k < 0 || k > n) return M();
+    if (n >= MOD) return C(n%MOD, k%MOD) * C(n/MOD, k/MOD);
+    Grow(n);
+    return Fact()[n] * InvFact()[k] * InvFact()[n-k];
+  }
+  // Ordered selections, n!/(n-k)!.  Requires n < MOD.
+  static M P(int n, int k) {
+    if (k < 0 || k > n) return M();
+    assert(n < MOD);
+    Grow(n);
+    return Fact()[n] * InvFact()[n-k];
+  }
+};
+
+//// *** Convolution ***
+
+// Number-theoretic transform modulo a prime MOD = c*2^k+1 < 2^30 with
+// primitive root G; n must be a power of 2 <= 2^k.  Forward() is a radix-4
+// decimation-in-frequency pass that leaves its output in bit-reversed order,
+// and Inverse() (which includes the 1/n) reads that order, so convolutions
+// never permute.  Transform() gives the DFT in natural order.
+template<unsigned MOD, unsigned G> struct NTT {
+  static inline unsigned Add(unsigned a, unsigned b) {a += b; return (a >= MOD) ? a-MOD : a;}
+  static inline unsigned Sub(unsigned a, unsigned b) {return (a >= b) ? a-b : a+MOD-b;}
+  static inline unsigned Mul(unsigned a, unsigned b) {return (uint64)a*b%MOD;}
+  // Twiddles for all sizes up to n, kept between calls: roots[h+j] = w^j for
+  // w a primitive (2h)-th root of unity and j < h; iroots[h+j] = w^-j.  Each
+  // thread keeps its own tables, so transforms may run concurrently.
+  static void Prepare(int n, const unsigned*& roots, const unsigned*& iroots) {
+    static thread_local vector<unsigned> r(1), ir(1);
+    for (int h = r.size(); h < n; h *= 2) {
+      r.resize(2*h); ir.resize(2*h);
+      unsigned w = ModPow(G, (MOD-1)/(2*h), MOD), iw = ModInv(w, MOD);
+      r[h] = ir[h] = 1;
+      for (int j = 1; j < h; j++) r[h+j] = Mul(r[h+j-1], w), ir[h+j] = Mul(ir[h+j-1], iw);
+    }
+    roots = &r[0]; iroots = &ir[0];
+  }
+  static void Forward(unsigned* a, int n) {
+    const unsigned *r, *ir;
+    Prepare(n, r, ir);
+    int len = n;
+    if (__builtin_ctz(n) & 1) {
+      for (int j = 0; j < n/2; j++) {
+        unsigned u = a[j], v = a[j+n/2];
+        a[j] = Add(u, v); a[j+n/2] = Mul(Sub(u, v), r[n/2+j]);
+      }
+      len /= 2;
+    }
+    // Two radix-2 levels at once: w = w_len, and r[3] is a 4th root of 1.
+    for (; len >= 4; len /= 4) {
+      int q = len/4;
+      for (int i = 0; i < n; i += len)
+      for (int j = 0; j < q; j++) {
+        unsigned w1 = r[2*q+j], w2 = r[q+j], w3 = Mul(w1, w2), *p = a+i+j;
+        unsigned s02 = Add(p[0], p[2*q]), d02 = Sub(p[0], p[2*q]);
+        unsigned s13 = Add(p[q], p[3*q]), d13 = Mul(Sub(p[q], p[3*q]), r[3]);
+        p[0] = Add(s02, s13);
+        p[q] = Mul(Sub(s02, s13), w2);
+        p[2*q] = Mul(Add(d02, d13), w1);
+        p[3*q] = Mul(Sub(d02, d13), w3);
+      }
+    }
+  }
+  static void Inverse(unsigned* a, int n) {
+    const unsigned *r, *ir;
+    Prepare(n, r, ir);
+    int len = 4;
+    for (; len <= n; len *= 4) {
+      int q = len/4;
+      for (int i = 0; i < n; i += len)
+      for (int j = 0; j < q; j++) {
+        unsigned w1 = ir[2*q+j], w2 = ir[q+j], w3 = Mul(w1, w2), *p = a+i+j;
+        unsigned t = Mul(p[q], w2), y0 = Add(p[0], t), y1 = Sub(p[0], t);
+        unsigned c2 = Mul(p[2*q], w1), c3 = Mul(p[3*q], w3);
+        unsigned s2 = Add(c2, c3), s3 = Mul(Sub(c2, c3), ir[3]);
+        p[0] = Add(y0, s2); p[2*q] = Sub(y0, s2);
+        p[q] = Add(y1, s3); p[3*q] = Sub(y1, s3);
+      }
+    }
+    if (len/2 == n) {
+      for (int j = 0; j < n/2; j++) {
+        unsigned u = a[j], v = Mul(a[j+n/2], ir[n/2+j]);
+        a[j] = Add(u, v); a[j+n/2] = Sub(u, v);
+      }
+    }
+    unsigned ninv = ModInv(n, MOD);
+    for (int i = 0; i < n; i++) a[i] = Mul(a[i], ninv);
+  }
+  static void BitReverse(unsigned* a, int n) {
+    for (int i = 1, j = 0; i < n; i++) {
+      int bit = n>>1;
+      for (; j&bit; bit >>= 1) j ^= bit;
+      j ^= bit;
+      if (i < j) swap(a[i], a[j]);
+    }
+  }
+  static void Transform(unsigned* a, int n, bool inverse) {
+    if (inverse) {BitReverse(a, n); Inverse(a, n);}
+    else {Forward(a, n); BitReverse(a, n);}
+  }
+  // ret = a * b mod MOD, cyclic of length n (a power of 2 dividing MOD-1).
+  // Inputs need not be reduced.
+  static void Multiply(const unsigned* a, int na, const unsigned* b, int nb, int n, vector<unsigned>& ret) {
+    assert((MOD-1) % n == 0);
+    ret.assign(n, 0);
+    for (int i = 0; i < na; i++) ret[i] = a[i]%MOD;
+    Forward(&ret[0], n);
+    if (a == b && na == nb) {
+      for (int i = 0; i < n; i++) ret[i] = Mul(ret[i], ret[i]);
+    } else {
+      vector<unsigned> y(n);
+      for (int i = 0; i < nb; i++) y[i] = b[i]%MOD;
+      Forward(&y[0], n);
+      for (int i = 0; i < n; i++) ret[i] = Mul(ret[i], y[i]);
+    }
+    Inverse(&ret[0], n);
+  }
+};
+
+// Product of two polynomials over ModInt<MOD>, for any MOD.  Uses one NTT
+// when MOD is 998244353, otherwise NTTs modulo three primes combined by CRT
+// (exact while min(a.size(), b.size()) * MOD^2 < 2^86).  The result length
+// must be at most 2^23, the largest transform modulo 998244353 = 119*2^23+1.
+template<int MOD> vector<ModInt<MOD> > Convolve(const vector<ModInt<MOD> >& a, const vector<ModInt<MOD> >& b) {
+  #define CONVOLVE__NAIVE 32
+  typedef ModInt<MOD> M;
+  int na = a.size(), nb = b.size(), n = 1;
+  if (!na || !nb) return vector<M>();
+  vector<M> ret(na+nb-1);
+  if (min(na, nb) <= CONVOLVE__NAIVE) {
+    for (int i = 0; i < na; i++)
+    for (int j = 0; j < nb; j++)
+      ret[i+j] += a[i] * b[j];
+    return ret;
+  }
+  while (n < na+nb-1) n <<= 1;
+  assert(n <= (1<<23));
+  vector<unsigned> x(na), y(nb), c1, c2, c3;
+  for (int i = 0; i < na; i++) x[i] = a[i].toint();
+  for (int i = 0; i < nb; i++) y[i] = b[i].toint();
+  const unsigned P1 = 998244353, P2 = 167772161, P3 = 469762049;
+  NTT<P1, 3>::Multiply(&x[0], na, &y[0], nb, n, c1);
+  if (MOD == P1) {
+    for (int i = 0; i < na+nb-1; i++) ret[i].value = c1[i];
+    return ret;
+  }
+  NTT<P2, 3>::Multiply(&x[0], na, &y[0], nb, n, c2);
+  NTT<P3, 3>::Multiply(&x[0], na, &y[0], nb, n, c3);
+  uint64 inv12 = ModInv(P1, P2), inv13 = ModInv(P1, P3), inv23 = ModInv(P2, P3);
+  uint64 p1 = P1%MOD, p12 = (uint64)P1*P2%MOD;
+  for (int i = 0; i < na+nb-1; i++) {
+    uint64 x1 = c1[i];
+    uint64 x2 = (c2[i] + P2 - x1%P2) * inv12 % P2;
+    uint64 x3 = ((c3[i] + P3 - x1%P3) * inv13 % P3 + P3 - x2) * inv23 % P3;
+    ret[i].value = (x1 + p1*x2 + p12*x3) % MOD;
+  }
+  return ret;
+}
+
 //// *** Large numbers ***
 
-void Mult128(uint64 a, uint64 b, uint64& hi, uint64& lo) {
+inline void Mult128(uint64 a, uint64 b, uint64& hi, uint64& lo) {
+  #ifdef __SIZEOF_INT128__
+  unsigned __int128 p = (unsigned __int128)a*b;
+  hi = p>>64; lo = p;
+  #else
   uint64 ahi = (a>>32), alo = (a&0xffffffffLL);
   uint64 bhi = (b>>32), blo = (b&0xffffffffLL);
   hi = alo*blo;
@@ -287,6 +964,7 @@ void Mult128(uint64 a, uint64 b, uint64& hi, uint64& lo) {
   lo |= (hi&0xffffffffLL)<<32;
   hi >>= 32;
   hi += ahi*bhi + (car<<32);
+  #endif
 }
 
 #endif // __MATH_H
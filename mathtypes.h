@@ -6,7 +6,7 @@
 
 //// *** Integer with constant modulus ***
 
-// Note: MOD should be < 2^30.  If division is used, MOD must be prime.
+// Note: MOD should be < 2^30.  Divisors must be coprime to MOD.
 template<int MOD> struct ModInt {
   int value;
   ModInt() : value(0) {}
@@ -16,7 +16,7 @@ template<int MOD> struct ModInt {
     ModInt ret, a; ret.value = (MOD!=1); a.value = value;
     for(;;) {if (b&1) ret *= a; if (!(b>>=1)) return ret; a *= a;}
   }
-  ModInt Inverse() const { return Pow(MOD-2); }
+  ModInt Inverse() const { return (int)ModInv(toint(), MOD); }
   ModInt operator+(const ModInt& m) const {return value+m.value;}
   ModInt& operator+=(const ModInt& m) {value = (value+m.value) % MOD; return *this;}
   ModInt operator-(const ModInt& m) const {return value-m.value;}
@@ -32,6 +32,253 @@ template<int MOD> struct ModInt {
   friend ostream& operator<<(ostream& out, const ModInt& m) {out << m.toint(); return out;}
 };
 
+// ModInt in Montgomery form (value = x*2^32 mod MOD, kept in [0, MOD)), so
+// multiplication needs no hardware division and addition is branch-free.
+// Conversion happens only in the constructors and toint().
+// Note: MOD must be odd and < 2^30.  Divisors must be coprime to MOD.
+template<int MOD> struct MontModInt {
+  static_assert(MOD%2 == 1 && MOD < (1<<30), "MOD must be odd and < 2^30");
+  unsigned value;
+  static constexpr unsigned InvStep(unsigned x) {return x * (2 - MOD*x);}
+  // -1/MOD mod 2^32 (each Newton step doubles the correct low bits), and
+  // 2^64 mod MOD.
+  static constexpr unsigned MINV = -InvStep(InvStep(InvStep(InvStep(InvStep(MOD)))));
+  static constexpr unsigned R2 = -(unsigned long long)MOD % MOD;
+  // x / 2^32 mod MOD, for x < MOD * 2^32.
+  static unsigned Reduce(unsigned long long x) {
+    unsigned r = (x + (unsigned long long)((unsigned)x * MINV) * MOD) >> 32;
+    return Fix(r - MOD);
+  }
+  // Maps x in [-MOD, MOD) to [0, MOD).
+  static unsigned Fix(unsigned x) {return x + (MOD & -(x >> 31));}
+  MontModInt() : value(0) {}
+  MontModInt(int v) : value(Reduce((unsigned long long)Fix(v % MOD) * R2)) {}
+  MontModInt(long long v) : value(Reduce((unsigned long long)Fix(v % MOD) * R2)) {}
+  MontModInt Pow(int b) const {
+    MontModInt ret(MOD!=1), a = *this;
+    for(;;) {if (b&1) ret *= a; if (!(b>>=1)) return ret; a *= a;}
+  }
+  MontModInt Inverse() const { return (int)ModInv(toint(), MOD); }
+  MontModInt operator+(const MontModInt& m) const {MontModInt r = *this; return r += m;}
+  MontModInt& operator+=(const MontModInt& m) {value = Fix(value + m.value - MOD); return *this;}
+  MontModInt operator-(const MontModInt& m) const {MontModInt r = *this; return r -= m;}
+  MontModInt& operator-=(const MontModInt& m) {value = Fix(value - m.value); return *this;}
+  MontModInt operator-() const {MontModInt r; return r -= *this;}
+  MontModInt operator*(const MontModInt& m) const {MontModInt r = *this; return r *= m;}
+  MontModInt& operator*=(const MontModInt& m) {value = Reduce((unsigned long long)value * m.value); return *this;}
+  MontModInt operator/(const MontModInt& m) const {return *this * m.Inverse();}
+  MontModInt& operator/=(const MontModInt& m) {return *this *= m.Inverse();}
+  bool operator==(const MontModInt& m) const {return value == m.value;}
+  bool operator!=(const MontModInt& m) const {return value != m.value;}
+  int toint() const {return Reduce(value);}
+  friend ostream& operator<<(ostream& out, const MontModInt& m) {out << m.toint(); return out;}
+};
+
+//// *** Integer with runtime modulus ***
+
+// Barrett reduction by a modulus 1 <= m < 2^31 fixed at runtime: Reduce(z)
+// is z % m for z < m^2, by a multiply-high with the precomputed 2^64/m
+// instead of a hardware division.
+struct Barrett {
+  unsigned m;
+  unsigned long long im;
+  constexpr explicit Barrett(unsigned m = 1) : m(m), im(~0ULL/m + 1) {}
+  unsigned Reduce(unsigned long long z) const {
+    unsigned long long q = ((unsigned __int128)z * im) >> 64;
+    unsigned v = z - q*m;
+    return (m <= v) ? v + m : v;
+  }
+  unsigned Mul(unsigned a, unsigned b) const {return Reduce((unsigned long long)a * b);}
+};
+
+// ModInt whose modulus (< 2^31) is set at runtime with SetMod().  Each
+// thread, and each ID, has its own modulus, so independent computations
+// can use different moduli.  Inverse() needs only gcd(value, Mod()) == 1.
+template<int ID = 0> struct DynModInt {
+  unsigned value;
+  static Barrett& Context() {static thread_local Barrett b; return b;}
+  static void SetMod(unsigned m) {Context() = Barrett(m);}
+  static unsigned Mod() {return Context().m;}
+  DynModInt() : value(0) {}
+  DynModInt(int v) {int x = v % (int)Mod(); value = (x < 0) ? x + Mod() : x;}
+  DynModInt(long long v) {long long x = v % Mod(); value = (x < 0) ? x + Mod() : x;}
+  DynModInt Pow(long long b) const {
+    DynModInt ret(1), a = *this;
+    for(;;) {if (b&1) ret *= a; if (!(b>>=1)) return ret; a *= a;}
+  }
+  DynModInt Inverse() const {DynModInt r; r.value = ModInv(value, Mod()); return r;}
+  DynModInt operator+(const DynModInt& m) const {DynModInt r = *this; return r += m;}
+  DynModInt& operator+=(const DynModInt& m) {
+    value += m.value;
+    value -= (value >= Mod()) ? Mod() : 0;
+    return *this;
+  }
+  DynModInt operator-(const DynModInt& m) const {DynModInt r = *this; return r -= m;}
+  DynModInt& operator-=(const DynModInt& m) {
+    value -= m.value;
+    value += (value >> 31) ? Mod() : 0;
+    return *this;
+  }
+  DynModInt operator-() const {DynModInt r; return r -= *this;}
+  DynModInt operator*(const DynModInt& m) const {DynModInt r = *this; return r *= m;}
+  DynModInt& operator*=(const DynModInt& m) {value = Context().Mul(value, m.value); return *this;}
+  DynModInt operator/(const DynModInt& m) const {return *this * m.Inverse();}
+  DynModInt& operator/=(const DynModInt& m) {return *this *= m.Inverse();}
+  bool operator==(const DynModInt& m) const {return value == m.value;}
+  bool operator!=(const DynModInt& m) const {return value != m.value;}
+  int toint() const {return value;}
+  friend ostream& operator<<(ostream& out, const DynModInt& m) {out << m.toint(); return out;}
+};
+
+//// *** Bulk ModInt operations ***
+
+// Elementwise operations on contiguous ModInt<MOD> spans, using AVX2 or
+// SSE4.1 when the CPU has them (checked once at runtime), else scalar code.
+// Products are reduced with a double-precision quotient estimate, which is
+// off by at most 1 for MOD < 2^30, then fixed with unsigned min().  Results
+// are in [0, MOD), and r may alias the inputs.
+template<int MOD> struct ModIntSpan {
+  static_assert(MOD < (1<<30), "ModIntSpan needs MOD < 2^30");
+  typedef ModInt<MOD> M;
+  enum {ADD, SUB, MUL, SCALE, MULADD};
+  // r = a + b, a - b, a * b, a * c and a + b * c.
+  static void Add(M* r, const M* a, const M* b, int n) {Run(ADD, r, a, b, M(), n);}
+  static void Sub(M* r, const M* a, const M* b, int n) {Run(SUB, r, a, b, M(), n);}
+  static void Mul(M* r, const M* a, const M* b, int n) {Run(MUL, r, a, b, M(), n);}
+  static void Scale(M* r, const M* a, M c, int n) {Run(SCALE, r, a, a, c, n);}
+  static void MulAdd(M* r, const M* a, const M* b, M c, int n) {Run(MULADD, r, a, b, c, n);}
+  // r[i] = 1/a[i] (0 where a[i] is 0) with one inversion and 3n multiplications.
+  static void Inverse(M* r, const M* a, int n) {
+    vector<M> pre(n+1, M(1));
+    for (int i = 0; i < n; i++) pre[i+1] = a[i].toint() ? pre[i] * a[i] : pre[i];
+    M inv = pre[n].Inverse();
+    for (int i = n-1; i >= 0; i--) {
+      M x = a[i];
+      r[i] = x.toint() ? inv * pre[i] : M();
+      if (x.toint()) inv *= x;
+    }
+  }
+  // Sum of a[i] * b[i].
+  static M Dot(const M* a, const M* b, int n) {
+    int i = 0;
+    unsigned long long sum = 0;
+    if (Level() >= 2) sum = Dot256(&a[0].value, &b[0].value, n, i);
+    else if (Level() >= 1) sum = Dot128(&a[0].value, &b[0].value, n, i);
+    for (; i < n; i++) sum += (long long)a[i].toint() * b[i].toint() % MOD;
+    return M((long long)(sum % MOD));
+  }
+  // 2 for AVX2, 1 for SSE4.1, 0 for scalar only.  May be lowered (e.g. to
+  // test the fallbacks), but not raised beyond what the CPU supports.
+  static int& Level() {
+    static int level = __builtin_cpu_supports("avx2") ? 2 : __builtin_cpu_supports("sse4.1") ? 1 : 0;
+    return level;
+  }
+
+  static void Run(int op, M* r, const M* a, const M* b, M c, int n) {
+    int i = 0, cv = c.toint();
+    if (Level() >= 2) Run256(op, &r[0].value, &a[0].value, &b[0].value, cv, n, i);
+    else if (Level() >= 1) Run128(op, &r[0].value, &a[0].value, &b[0].value, cv, n, i);
+    for (; i < n; i++) {
+      if (op == ADD) r[i].value = (a[i] + b[i]).toint();
+      else if (op == SUB) r[i].value = (a[i] - b[i]).toint();
+      else if (op == MUL) r[i].value = (a[i] * b[i]).toint();
+      else if (op == SCALE) r[i].value = (a[i] * c).toint();
+      else r[i].value = (a[i] + b[i] * c).toint();
+    }
+  }
+
+  // AVX2: 8 lanes.  Each Run/Dot handles whole vectors and advances i.
+  __attribute__((target("avx2"))) static inline __m256i Norm256(__m256i x) {
+    return _mm256_add_epi32(x, _mm256_and_si256(_mm256_srai_epi32(x, 31), _mm256_set1_epi32(MOD)));
+  }
+  __attribute__((target("avx2"))) static inline __m256i Fix256(__m256i x) {  // [-MOD, 2*MOD) to [0, MOD).
+    const __m256i m = _mm256_set1_epi32(MOD);
+    x = _mm256_min_epu32(x, _mm256_add_epi32(x, m));
+    return _mm256_min_epu32(x, _mm256_sub_epi32(x, m));
+  }
+  __attribute__((target("avx2"))) static inline __m256i MulMod256(__m256i a, __m256i b) {
+    const __m256d inv = _mm256_set1_pd(1.0/MOD);
+    __m128i q0 = _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_mul_pd(
+        _mm256_cvtepi32_pd(_mm256_castsi256_si128(a)), _mm256_cvtepi32_pd(_mm256_castsi256_si128(b))), inv));
+    __m128i q1 = _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_mul_pd(
+        _mm256_cvtepi32_pd(_mm256_extracti128_si256(a, 1)), _mm256_cvtepi32_pd(_mm256_extracti128_si256(b, 1))), inv));
+    __m256i q = _mm256_inserti128_si256(_mm256_castsi128_si256(q0), q1, 1);
+    return Fix256(_mm256_sub_epi32(_mm256_mullo_epi32(a, b), _mm256_mullo_epi32(q, _mm256_set1_epi32(MOD))));
+  }
+  __attribute__((target("avx2")))
+  static void Run256(int op, int* r, const int* a, const int* b, int c, int n, int& i) {
+    const __m256i vc = _mm256_set1_epi32(c);
+    for (; i+8 <= n; i += 8) {
+      __m256i x = Norm256(_mm256_loadu_si256((const __m256i*)(a+i))), y;
+      if (op != SCALE) y = Norm256(_mm256_loadu_si256((const __m256i*)(b+i)));
+      if (op == ADD) x = Fix256(_mm256_add_epi32(x, y));
+      else if (op == SUB) x = Fix256(_mm256_sub_epi32(x, y));
+      else if (op == MUL) x = MulMod256(x, y);
+      else if (op == SCALE) x = MulMod256(x, vc);
+      else x = Fix256(_mm256_add_epi32(x, MulMod256(y, vc)));
+      _mm256_storeu_si256((__m256i*)(r+i), x);
+    }
+  }
+  __attribute__((target("avx2")))
+  static unsigned long long Dot256(const int* a, const int* b, int n, int& i) {
+    __m256i acc = _mm256_setzero_si256();
+    for (; i+8 <= n; i += 8) {
+      __m256i x = Norm256(_mm256_loadu_si256((const __m256i*)(a+i)));
+      __m256i y = Norm256(_mm256_loadu_si256((const __m256i*)(b+i)));
+      acc = Fix256(_mm256_add_epi32(acc, MulMod256(x, y)));
+    }
+    unsigned lanes[8];
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+    unsigned long long sum = 0;
+    for (int j = 0; j < 8; j++) sum += lanes[j];
+    return sum;
+  }
+
+  // SSE4.1: 4 lanes.
+  __attribute__((target("sse4.1"))) static inline __m128i Norm128(__m128i x) {
+    return _mm_add_epi32(x, _mm_and_si128(_mm_srai_epi32(x, 31), _mm_set1_epi32(MOD)));
+  }
+  __attribute__((target("sse4.1"))) static inline __m128i Fix128(__m128i x) {
+    const __m128i m = _mm_set1_epi32(MOD);
+    x = _mm_min_epu32(x, _mm_add_epi32(x, m));
+    return _mm_min_epu32(x, _mm_sub_epi32(x, m));
+  }
+  __attribute__((target("sse4.1"))) static inline __m128i MulMod128(__m128i a, __m128i b) {
+    const __m128d inv = _mm_set1_pd(1.0/MOD);
+    __m128i ah = _mm_shuffle_epi32(a, 0xee), bh = _mm_shuffle_epi32(b, 0xee);
+    __m128i q0 = _mm_cvttpd_epi32(_mm_mul_pd(_mm_mul_pd(_mm_cvtepi32_pd(a), _mm_cvtepi32_pd(b)), inv));
+    __m128i q1 = _mm_cvttpd_epi32(_mm_mul_pd(_mm_mul_pd(_mm_cvtepi32_pd(ah), _mm_cvtepi32_pd(bh)), inv));
+    __m128i q = _mm_unpacklo_epi64(q0, q1);
+    return Fix128(_mm_sub_epi32(_mm_mullo_epi32(a, b), _mm_mullo_epi32(q, _mm_set1_epi32(MOD))));
+  }
+  __attribute__((target("sse4.1")))
+  static void Run128(int op, int* r, const int* a, const int* b, int c, int n, int& i) {
+    const __m128i vc = _mm_set1_epi32(c);
+    for (; i+4 <= n; i += 4) {
+      __m128i x = Norm128(_mm_loadu_si128((const __m128i*)(a+i))), y;
+      if (op != SCALE) y = Norm128(_mm_loadu_si128((const __m128i*)(b+i)));
+      if (op == ADD) x = Fix128(_mm_add_epi32(x, y));
+      else if (op == SUB) x = Fix128(_mm_sub_epi32(x, y));
+      else if (op == MUL) x = MulMod128(x, y);
+      else if (op == SCALE) x = MulMod128(x, vc);
+      else x = Fix128(_mm_add_epi32(x, MulMod128(y, vc)));
+      _mm_storeu_si128((__m128i*)(r+i), x);
+    }
+  }
+  __attribute__((target("sse4.1")))
+  static unsigned long long Dot128(const int* a, const int* b, int n, int& i) {
+    __m128i acc = _mm_setzero_si128();
+    for (; i+4 <= n; i += 4) {
+      __m128i x = Norm128(_mm_loadu_si128((const __m128i*)(a+i)));
+      __m128i y = Norm128(_mm_loadu_si128((const __m128i*)(b+i)));
+      acc = Fix128(_mm_add_epi32(acc, MulMod128(x, y)));
+    }
+    unsigned lanes[4];
+    _mm_storeu_si128((__m128i*)lanes, acc);
+    return (unsigned long long)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+  }
+};
+
 //// *** Fraction class ***
 
 template<typename T = long long> struct Fract {
@@ -90,15 +337,22 @@ template<typename T> struct Polynomial {
   Polynomial operator/(const T& x) const {Polynomial ret = *this; return ret /= x;}
   Polynomial& operator/=(const T& x) {for (int i = 0; i < co.size(); i++) co[i] /= x; Simplify(); return *this;}
   Polynomial operator*(const Polynomial& p) const {
-    if (!co.size() || !p.co.size()) return Polynomial();
     Polynomial ret;
-    ret.co.resize(co.size() + p.co.size() - 1);
-    for (int i = 0; i < co.size(); i++)
-    for (int j = 0; j < p.co.size(); j++)
-      ret.co[i+j] += co[i] * p.co[j];
+    ret.co = MulCo(co, p.co);
     ret.Simplify();
     return ret;
   }
+  // Long multiplication, except that ModInt coefficients use Convolve().
+  template<typename U> static vector<U> MulCo(const vector<U>& a, const vector<U>& b) {
+    if (!a.size() || !b.size()) return vector<U>();
+    vector<U> ret(a.size() + b.size() - 1);
+    for (int i = 0; i < a.size(); i++)
+    for (int j = 0; j < b.size(); j++)
+      ret[i+j] += a[i] * b[j];
+    return ret;
+  }
+  template<int MOD> static vector<ModInt<MOD> > MulCo(const vector<ModInt<MOD> >& a, const vector<ModInt<MOD> >& b)
+    {return Convolve(a, b);}
   Polynomial& operator*=(const Polynomial& p) {*this = *this * p; return *this;}
   friend ostream& operator<<(ostream& out, const Polynomial& p) {
     if (!p.co.size()) {out << 0; return out;}
@@ -175,13 +429,13 @@ template<typename T> string PolynomialToString(const Polynomial<T>& p) {
 struct SimpleBigInt {
   bool neg;
   string dig;
-  SimpleBigInt() : dig("0"), neg(false) {}
+  SimpleBigInt() : neg(false), dig("0") {}
   SimpleBigInt(int x)
     {if ((neg=x<0)) x=-x; do {dig.push_back(x%10+'0'); x /= 10;} while (x); reverse(dig.begin(), dig.end());}
   SimpleBigInt(long long x)
     {if ((neg=x<0)) x=-x; do {dig.push_back(x%10+'0'); x /= 10;} while (x); reverse(dig.begin(), dig.end());}
   SimpleBigInt(const string& s) {if ((neg=(s[0]=='-'))) dig = s.substr(1); else dig = s;}
-  SimpleBigInt(const string& dig, bool neg) : dig(dig), neg(neg) {}
+  SimpleBigInt(const string& dig, bool neg) : neg(neg), dig(dig) {}
   static bool LessThan(const string& a, bool an, const string& b, bool bn, bool count_eq) {
     if (an != bn) return an;
     if (a.size() != b.size()) return (a.size() < b.size()) ^ an;
@@ -271,78 +525,181 @@ struct SimpleBigInt {
   friend ostream& operator<<(ostream& out, const SimpleBigInt& b) {if (b.neg) out << '-'; out << b.dig; return out;}
 };
 
+// A vector that keeps up to N elements inside the object, and only goes to
+// the heap when it grows past that.  T must be a plain number type.
+template<class T, int N> struct SmallVector {
+  T *p;
+  int n, cap;
+  T buf[N];
+
+  SmallVector() : p(buf), n(0), cap(N) {}
+  explicit SmallVector(int sz, const T& v = T()) : p(buf), n(0), cap(N) {assign(sz, v);}
+  SmallVector(const SmallVector& v) : p(buf), n(0), cap(N) {*this = v;}
+  SmallVector(SmallVector&& v) noexcept : p(buf), n(0), cap(N) {*this = move(v);}
+  ~SmallVector() {if (p != buf) delete[] p;}
+  SmallVector& operator=(const SmallVector& v) {
+    if (this != &v) {reserve(v.n); copy(v.p, v.p+v.n, p); n = v.n;}
+    return *this;
+  }
+  // Moves never allocate (an inline v fits in our buffer), so containers of
+  // SmallVectors can move them when they reallocate.
+  SmallVector& operator=(SmallVector&& v) noexcept {
+    if (this == &v) return *this;
+    if (v.p == v.buf) return *this = v;
+    if (p != buf) delete[] p;
+    p = v.p; n = v.n; cap = v.cap;
+    v.p = v.buf; v.n = 0; v.cap = N;
+    return *this;
+  }
+
+  inline int size() const {return n;}
+  inline bool empty() const {return !n;}
+  inline int capacity() const {return cap;}
+  inline T* data() {return p;}
+  inline const T* data() const {return p;}
+  inline T& operator[](int i) {return p[i];}
+  inline const T& operator[](int i) const {return p[i];}
+  inline T* begin() {return p;}
+  inline const T* begin() const {return p;}
+  inline T* end() {return p+n;}
+  inline const T* end() const {return p+n;}
+  inline reverse_iterator<T*> rbegin() {return reverse_iterator<T*>(p+n);}
+  inline reverse_iterator<const T*> rbegin() const {return reverse_iterator<const T*>(p+n);}
+  inline reverse_iterator<T*> rend() {return reverse_iterator<T*>(p);}
+  inline reverse_iterator<const T*> rend() const {return reverse_iterator<const T*>(p);}
+  inline T& back() {return p[n-1];}
+  inline const T& back() const {return p[n-1];}
+
+  void reserve(int m) {
+    if (m <= cap) return;
+    cap = max(m, 2*cap);
+    T *q = new T[cap];
+    copy(p, p+n, q);
+    if (p != buf) delete[] p;
+    p = q;
+  }
+  inline void push_back(const T& v) {if (n == cap) reserve(n+1); p[n++] = v;}
+  inline void pop_back() {n--;}
+  inline void clear() {n = 0;}
+  void resize(int m, const T& v = T()) {
+    reserve(m);
+    if (m > n) fill(p+n, p+m, v);
+    n = m;
+  }
+  void assign(int m, const T& v) {n = 0; resize(m, v);}
+  template<class It, class = typename enable_if<!is_integral<It>::value>::type>
+  void assign(It first, It last) {
+    n = 0;
+    insert(p, first, last);
+  }
+  template<class It> T* insert(T* pos, It first, It last) {
+    int i = pos-p, k = distance(first, last);
+    if (k && Owns(first)) {
+      // reserve() and the shift would overwrite the range; copy it out first.
+      SmallVector t;
+      t.assign(first, last);
+      return insert(p+i, t.begin(), t.end());
+    }
+    reserve(n+k);
+    copy_backward(p+i, p+n, p+n+k);
+    copy(first, last, p+i);
+    n += k;
+    return p+i;
+  }
+  bool Owns(const T* q) const {return q >= p && q < p+n;}
+  bool Owns(T* q) const {return Owns((const T*)q);}
+  template<class It> bool Owns(const It&) const {return false;}
+  void swap(SmallVector& v) {
+    if (p != buf && v.p != v.buf) {std::swap(p, v.p); std::swap(n, v.n); std::swap(cap, v.cap); return;}
+    SmallVector t(move(v));
+    v = move(*this);
+    *this = move(t);
+  }
+  bool operator==(const SmallVector& v) const {return n == v.n && equal(p, p+n, v.p);}
+  bool operator!=(const SmallVector& v) const {return !(*this == v);}
+};
+
 // Copyright (c) Derek Kisman (SnapDragon)  dkisman@gmail.com
 // You must ask permission to use my BigInt code in your contests
 const string DIGITS = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
 template<int RADIX, int CHUNKRADIX=RADIX, int CHUNKSIZE=1, class CT=char>
 struct BigInt {
-  vector<CT> ch;
+  // Little-endian chunks.  Values of up to 4 chunks need no heap allocation.
+  typedef SmallVector<CT, 4> Chunks;
+  Chunks ch;
   bool neg;
+  // Bits per chunk if CHUNKRADIX is a power of two (which the bitwise
+  // operations require), else 0.
+  enum {CHUNKBITS = (CHUNKRADIX & (CHUNKRADIX-1)) ? 0 : __builtin_ctz(CHUNKRADIX)};
+  static int64 ChunkRadix() {return CHUNKRADIX;}
 
-  BigInt& operator+=(const BigInt& b) {
+  // r = a + b, r = a - b and r = a * b, reusing r's storage.  r may alias a
+  // and/or b (multiplication then needs a temporary).
+  static void Add(const BigInt& a, const BigInt& b, BigInt& r) {
+    if (&r == &b) {r.AddSigned(a, a.neg); return;}
+    if (&r != &a) r = a;
+    r.AddSigned(b, b.neg);
+  }
+  static void Sub(const BigInt& a, const BigInt& b, BigInt& r) {
+    if (&r == &b && &r != &a) {r.AddSigned(a, !a.neg); r.neg = !r.neg && !r.zero(); return;}
+    if (&r != &a) r = a;
+    r.AddSigned(b, !b.neg);
+  }
+  static void Mul(const BigInt& a, const BigInt& b, BigInt& r) {
+    if (a.zero() || b.zero()) {r.ch.clear(); r.neg = false; return;}
+    bool rneg = a.neg ^ b.neg;
+    const BigInt& x = (a.ch.size() >= b.ch.size()) ? a : b;
+    const BigInt& y = (a.ch.size() >= b.ch.size()) ? b : a;
+    if (&r == &a || &r == &b) {
+      Chunks ret(x.ch.size() + y.ch.size());
+      MulSpan(&ret[0], &x.ch[0], x.ch.size(), &y.ch[0], y.ch.size());
+      r.ch.swap(ret);
+    } else {
+      r.ch.resize(x.ch.size() + y.ch.size());
+      MulSpan(&r.ch[0], &x.ch[0], x.ch.size(), &y.ch[0], y.ch.size());
+    }
+    r.neg = rneg;
+    r.trim();
+  }
+  // Replaces the chunks by CHUNKRADIX^size - chunks and flips the sign, which
+  // undoes a subtraction that wrapped below zero.
+  void Negate() {
+    int car = 0;
+    for (auto it = ch.begin(); it != ch.end(); it++) {
+      int x = car + CHUNKRADIX - *it;
+      *it = x%CHUNKRADIX;
+      car = x/CHUNKRADIX - 1;
+    }
+    neg = !neg;
+  }
+  // *this += (bneg ? -|b| : |b|), in place.  b may alias *this.
+  BigInt& AddSigned(const BigInt& b, bool bneg) {
     int car = 0; unsigned x;
     for (int i = 0; i < ch.size() || i < b.ch.size(); i++) {
       x = CHUNKRADIX + car + ((i<ch.size()) ? ch[i] : 0);
-      if (neg == b.neg) x += (i<b.ch.size()) ? b.ch[i] : 0;
+      if (neg == bneg) x += (i<b.ch.size()) ? b.ch[i] : 0;
       else x -= (i<b.ch.size()) ? b.ch[i] : 0;
       if (i == ch.size()) ch.push_back(x%CHUNKRADIX);
       else ch[i] = x%CHUNKRADIX;
       car = (x/CHUNKRADIX)-1;
     }
-    if (car == -1) {
-      neg = !neg;
-      auto it = ch.begin();
-      for (car = 0; it != ch.end(); it++) {
-        x = car + CHUNKRADIX - *it;
-        *it = x%CHUNKRADIX;
-        car = (x/CHUNKRADIX)-1;
-      }
-    } else if (car) ch.push_back(car);
-    trim();
-    return *this;
-  }
-  inline BigInt operator+(const BigInt& b) const {return BigInt(*this)+=b;}
-  inline BigInt& operator-=(const BigInt& b) {return *this += -b;}
-  inline BigInt operator-(const BigInt& b) const {return BigInt(*this)-=b;}
-  BigInt& operator*=(const BigInt& b) {
-    BigInt b2(*this); *this = BigInt();
-    vector<CT> zeros;
-    for (auto it = b.ch.begin(); it != b.ch.end(); it++) {
-      BigInt b3 = b2 * *it;
-      b3.ch.insert(b3.ch.begin(), zeros.begin(), zeros.end());
-      *this += b3;
-      zeros.push_back(0);
-    }
-    if (b.neg && !zero()) neg = !neg;
-    return *this;
-  }
-  inline BigInt operator*(const BigInt& b) const {return BigInt(*this)*=b;}
-  BigInt& operator/=(BigInt b) {
-    bool retneg = (b.neg) ? !neg : neg;
-    b.neg = neg = false;
-    if (b > *this || b.zero()) return (*this=BigInt());
-    if (b.ch.size() == 1) return (*this /= retneg ? -b.ch[0] : b.ch[0]);
-    if (CHUNKRADIX >= (1<<21)) {
-      int bm = CHUNKRADIX/b.ch.back() + 1; b *= bm; *this *= bm;
-    }
-    int64 p, q = (int64)CHUNKRADIX*b.ch.back() + b.ch[b.ch.size()-2];
-    vector<CT> ret(ch.size()-b.ch.size()+1);
-    b.ch.insert(b.ch.begin(), ret.begin(), ret.end());
-    for (int i = ret.size()-1, j = ch.size()-1; i >= 0; i--, j--) {
-      b.ch.erase(b.ch.begin());
-      if (j >= ch.size()) {ret[i] = 0; continue;}
-      p = (int64)CHUNKRADIX*ch[j] + ch[j-1] + 1;
-      if (j+1 < ch.size()) p += (int64)CHUNKRADIX*CHUNKRADIX*ch[j+1];
-      *this -= b*(ret[i] = p/q);
-      while (neg) {*this += b; ret[i]--;}
-    }
-    ch = ret; neg = retneg;
+    if (car == -1) Negate();
+    else if (car) ch.push_back(car);
     trim();
     return *this;
   }
-  inline BigInt operator/(const BigInt& b) const {return BigInt(*this)/=b;}
-  inline BigInt& operator%=(const BigInt& b) {return *this -= (*this/b)*b;}
-  inline BigInt operator%(const BigInt& b) const {return BigInt(*this)%=b;}
+  inline BigInt& operator+=(const BigInt& b) {return AddSigned(b, b.neg);}
+  inline BigInt operator+(const BigInt& b) const& {BigInt r; Add(*this, b, r); return r;}
+  inline BigInt operator+(const BigInt& b) && {return move(*this += b);}
+  inline BigInt& operator-=(const BigInt& b) {return AddSigned(b, !b.neg);}
+  inline BigInt operator-(const BigInt& b) const& {BigInt r; Sub(*this, b, r); return r;}
+  inline BigInt operator-(const BigInt& b) && {return move(*this -= b);}
+  BigInt& operator*=(const BigInt& b) {Mul(*this, b, *this); return *this;}
+  inline BigInt operator*(const BigInt& b) const {BigInt r; Mul(*this, b, r); return r;}
+  BigInt& operator/=(const BigInt& b) {DivMod(*this, b, this, NULL); return *this;}
+  inline BigInt operator/(const BigInt& b) const {BigInt q; DivMod(*this, b, &q, NULL); return q;}
+  BigInt& operator%=(const BigInt& b) {DivMod(*this, b, NULL, this); return *this;}
+  inline BigInt operator%(const BigInt& b) const {BigInt r; DivMod(*this, b, NULL, &r); return r;}
   BigInt& operator*=(int x) {
     if (!x || zero()) return (*this = BigInt());
     neg ^= (x<0);
@@ -377,6 +734,87 @@ struct BigInt {
     return neg ? -ret : ret;
   }
 
+  // Bitwise operations, for power-of-two CHUNKRADIX only.  They act on the
+  // magnitude, so x << k == x * 2^k and x >> k == x / 2^k (truncating); the
+  // sign of a & b, a | b and a ^ b is the same operation on the signs.
+  BigInt& operator<<=(int k) {
+    static_assert(CHUNKBITS > 0, "bitwise operations need a power-of-two CHUNKRADIX");
+    if (k < 0) return *this >>= -k;
+    if (zero()) return *this;
+    int n = ch.size(), q = k/CHUNKBITS;
+    ch.resize(n+q+1);
+    ch[n] = ShlSpan(&ch[0], &ch[0], n, k%CHUNKBITS);
+    copy_backward(ch.begin(), ch.begin()+n+1, ch.end());
+    fill(ch.begin(), ch.begin()+q, 0);
+    trim();
+    return *this;
+  }
+  BigInt& operator>>=(int k) {
+    static_assert(CHUNKBITS > 0, "bitwise operations need a power-of-two CHUNKRADIX");
+    if (k < 0) return *this <<= -k;
+    int n = ch.size(), q = k/CHUNKBITS;
+    if (q >= n) {ch.clear(); neg = false; return *this;}
+    copy(ch.begin()+q, ch.end(), ch.begin());
+    ch.resize(n-q);
+    ShrSpan(&ch[0], &ch[0], n-q, k%CHUNKBITS);
+    trim();
+    if (zero()) neg = false;
+    return *this;
+  }
+  inline BigInt operator<<(int k) const {return BigInt(*this) <<= k;}
+  inline BigInt operator>>(int k) const {return BigInt(*this) >>= k;}
+  BigInt& operator&=(const BigInt& b) {
+    static_assert(CHUNKBITS > 0, "bitwise operations need a power-of-two CHUNKRADIX");
+    if (ch.size() > b.ch.size()) ch.resize(b.ch.size());
+    for (int i = 0; i < ch.size(); i++) ch[i] &= b.ch[i];
+    neg &= b.neg;
+    trim();
+    if (zero()) neg = false;
+    return *this;
+  }
+  BigInt& operator|=(const BigInt& b) {
+    static_assert(CHUNKBITS > 0, "bitwise operations need a power-of-two CHUNKRADIX");
+    if (ch.size() < b.ch.size()) ch.resize(b.ch.size(), 0);
+    for (int i = 0; i < b.ch.size(); i++) ch[i] |= b.ch[i];
+    neg |= b.neg;
+    return *this;
+  }
+  BigInt& operator^=(const BigInt& b) {
+    static_assert(CHUNKBITS > 0, "bitwise operations need a power-of-two CHUNKRADIX");
+    if (ch.size() < b.ch.size()) ch.resize(b.ch.size(), 0);
+    for (int i = 0; i < b.ch.size(); i++) ch[i] ^= b.ch[i];
+    neg ^= b.neg;
+    trim();
+    if (zero()) neg = false;
+    return *this;
+  }
+  inline BigInt operator&(const BigInt& b) const {return BigInt(*this) &= b;}
+  inline BigInt operator|(const BigInt& b) const {return BigInt(*this) |= b;}
+  inline BigInt operator^(const BigInt& b) const {return BigInt(*this) ^= b;}
+  // Number of bits in |x|; 0 for zero.
+  int bit_length() const {
+    static_assert(CHUNKBITS > 0, "bitwise operations need a power-of-two CHUNKRADIX");
+    if (zero()) return 0;
+    return (ch.size()-1)*CHUNKBITS + 32 - __builtin_clz((unsigned)ch.back());
+  }
+  int popcount() const {
+    static_assert(CHUNKBITS > 0, "bitwise operations need a power-of-two CHUNKRADIX");
+    int ret = 0;
+    for (int i = 0; i < ch.size(); i++) ret += __builtin_popcount((unsigned)ch[i]);
+    return ret;
+  }
+  // Index of the lowest set bit of |x|; -1 for zero.
+  int trailing_zeros() const {
+    static_assert(CHUNKBITS > 0, "bitwise operations need a power-of-two CHUNKRADIX");
+    for (int i = 0; i < ch.size(); i++)
+      if (ch[i]) return i*CHUNKBITS + __builtin_ctz((unsigned)ch[i]);
+    return -1;
+  }
+  bool test_bit(int i) const {
+    static_assert(CHUNKBITS > 0, "bitwise operations need a power-of-two CHUNKRADIX");
+    return i/CHUNKBITS < ch.size() && (ch[i/CHUNKBITS] >> (i%CHUNKBITS)) & 1;
+  }
+
   bool operator<(const BigInt& b) const {
     if (neg != b.neg) return neg;
     if (ch.size() != b.ch.size()) return neg ^ (ch.size() < b.ch.size());
@@ -396,8 +834,7 @@ struct BigInt {
   inline bool operator>(const BigInt& b) const {return !(*this <= b);}
   inline bool operator>=(const BigInt& b) const {return !(*this < b);}
   inline bool operator!=(const BigInt& b) const {return !(*this == b);}
-  friend inline BigInt operator-(const BigInt& b)
-    {BigInt ret(b); ret.neg = !ret.neg; return ret;}
+  friend inline BigInt operator-(BigInt b) {b.neg = !b.neg && !b.zero(); return b;}
   friend inline BigInt abs(const BigInt& b) {return b.neg ? -b : b;}
 
   size_t digits() const {
@@ -413,6 +850,25 @@ struct BigInt {
       ret = ret*CHUNKRADIX + *it;
     return neg ? -ret : ret;
   }
+  string tostring(int radix) const {
+    if (radix == RADIX) return tostring();
+    if (zero()) return "0";
+    int base, d = RadixBlock(radix, base);
+    vector<BigInt> pw(1, BigInt(base));
+    BigInt x = abs(*this);
+    while (pw.size() < 2 || pw.back() <= x) pw.push_back(pw.back()*pw.back());
+    while (pw.size() > 2 && pw[pw.size()-2] > x) pw.pop_back();
+    vector<int> c(1<<(pw.size()-1));
+    ToChunks(x, pw.size()-2, pw, &c[0]);
+    string ret;
+    for (int j = 0; j < c.size(); j++)
+    for (int k = 0; k < d; k++, c[j] /= radix)
+      ret += DIGITS[c[j]%radix];
+    while (ret.size() > 1 && ret.back() == '0') ret.pop_back();
+    if (neg) ret += '-';
+    reverse(ret.begin(), ret.end());
+    return ret;
+  }
   string tostring() const {
     if (ch.size() == 0) return "0";
     auto it = ch.begin();
@@ -433,46 +889,940 @@ struct BigInt {
     {return o << b.tostring();}
   friend inline istream& operator>>(istream& i, BigInt& b)
     {string s; i >> s; b = BigInt(s); return i;}
+
+  // Binary serialization: a 16-byte header (chunk count, then CHUNKRADIX,
+  // sizeof(CT) and the sign) and the raw chunks in native byte order, padded
+  // to 8 bytes, so that large values save and load at disk speed.  Load()
+  // fails the stream if the header was written for another chunk type or
+  // is corrupt; a bogus chunk count just runs into the end of the stream,
+  // since chunks are read a block at a time.
+  static int64 SerialTag() {return (int64)CHUNKRADIX << 8 | sizeof(CT) << 1;}
+  void Save(ostream& out) const {
+    int64 hdr[2] = {(int64)ch.size(), SerialTag() | neg}, pad = 0;
+    out.write((const char*)hdr, sizeof(hdr));
+    out.write((const char*)ch.data(), ch.size()*sizeof(CT));
+    out.write((const char*)&pad, -ch.size()*sizeof(CT) & 7);
+  }
+  static BigInt Load(istream& in) {
+    #define BIGINT__LOADBLOCK (1<<20)
+    int64 hdr[2], pad;
+    BigInt ret;
+    if (!in.read((char*)hdr, sizeof(hdr))) return ret;
+    if (hdr[0] < 0 || hdr[0] > 0x7fffffff / sizeof(CT) || (hdr[1] & ~1LL) != SerialTag()) {
+      in.setstate(ios::failbit);
+      return ret;
+    }
+    for (int64 n = 0; n < hdr[0] && in; ) {
+      int64 m = min<int64>(hdr[0] - n, BIGINT__LOADBLOCK);
+      ret.ch.resize(n + m);
+      in.read((char*)(ret.ch.data() + n), m*sizeof(CT));
+      n += m;
+    }
+    in.read((char*)&pad, -hdr[0]*sizeof(CT) & 7);
+    if (!in) return BigInt();
+    ret.neg = hdr[1]&1;
+    return ret;
+  }
+  // A read-only view of a value written by Save(), over its bytes in place
+  // (e.g. an mmap'd file) so nothing is copied until value().  p must be
+  // 8-byte aligned; records are padded so the next one is too if the first
+  // was.  ch is NULL if the header is for another chunk type; bytes() steps
+  // to the next record.
+  struct View {
+    const CT* ch;
+    int n;
+    bool neg;
+    explicit View(const void* p) {
+      assert((size_t)p % 8 == 0);
+      const int64* hdr = (const int64*)p;
+      bool ok = hdr[0] >= 0 && hdr[0] <= 0x7fffffff / sizeof(CT) && (hdr[1] & ~1LL) == SerialTag();
+      ch = ok ? (const CT*)(hdr+2) : NULL;
+      n = ok ? hdr[0] : 0;
+      neg = ok && (hdr[1]&1);
+    }
+    size_t bytes() const {return 16 + (n*sizeof(CT)+7)/8*8;}
+    BigInt value() const {BigInt ret; ret.ch.assign(ch, ch+n); ret.neg = neg; return ret;}
+  };
   inline void trim() {
     while (ch.size() && !ch.back()) ch.pop_back();
     if (zero()) neg = false;
   }
 
+  // Arithmetic on raw little-endian chunk spans.  Spans may contain leading
+  // zeros, and all results are written to caller-provided storage.
+  #define BIGINT__KARATSUBA 32
+  #define BIGINT__TOOM3 160
+  #define BIGINT__NTT 3000
+  #define BIGINT__NTTMAXLOG 23
+
+  // a[0..na) += b[0..nb), nb <= na.  Returns the carry out of a.
+  static int AddTo(CT* a, int na, const CT* b, int nb) {
+    unsigned car = 0;
+    for (int i = 0; i < nb; i++) {
+      car += (unsigned)a[i] + b[i];
+      a[i] = car%CHUNKRADIX; car /= CHUNKRADIX;
+    }
+    for (int i = nb; car && i < na; i++) {
+      if (a[i] == CHUNKRADIX-1) a[i] = 0; else {a[i]++; car = 0;}
+    }
+    return car;
+  }
+  // a[0..na) -= b[0..nb), nb <= na.  Returns the borrow out of a.
+  static int SubFrom(CT* a, int na, const CT* b, int nb) {
+    int bor = 0;
+    for (int i = 0; i < nb; i++) {
+      int x = (int)a[i] - (int)b[i] - bor;
+      bor = x < 0;
+      a[i] = x + (CHUNKRADIX & -bor);
+    }
+    for (int i = nb; bor && i < na; i++) {
+      if (a[i] == 0) a[i] = CHUNKRADIX-1; else {a[i]--; bor = 0;}
+    }
+    return bor;
+  }
+  // a[0..na) += b[0..nb) * x, nb <= na.  Returns the carry out of a.
+  static uint64 AddMulSmall(CT* a, int na, const CT* b, int nb, uint64 x) {
+    uint64 car = 0;
+    for (int i = 0; i < nb; i++) {
+      car += a[i] + b[i] * x;
+      a[i] = car%CHUNKRADIX; car /= CHUNKRADIX;
+    }
+    for (int i = nb; car && i < na; i++) {
+      car += a[i];
+      a[i] = car%CHUNKRADIX; car /= CHUNKRADIX;
+    }
+    return car;
+  }
+  // a[0..na) -= b[0..nb) * x, nb <= na.  Returns 1 if the result went
+  // negative, in which case a holds it modulo CHUNKRADIX^na.
+  static int SubMulSmall(CT* a, int na, const CT* b, int nb, uint64 x) {
+    uint64 car = 0; int bor = 0;
+    for (int i = 0; i < na && (i < nb || car || bor); i++) {
+      if (i < nb) car += b[i] * x;
+      int64 y = (int64)a[i] - (int64)(car%CHUNKRADIX) - bor;
+      car /= CHUNKRADIX;
+      if (y < 0) {a[i] = y+CHUNKRADIX; bor = 1;} else {a[i] = y; bor = 0;}
+    }
+    return car || bor;
+  }
+  // r[0..n) = a[0..n) * x.  Returns the carry chunk.
+  static uint64 MulSmall(CT* r, const CT* a, int n, uint64 x) {
+    uint64 car = 0;
+    for (int i = 0; i < n; i++) {
+      car += a[i] * x;
+      r[i] = car%CHUNKRADIX; car /= CHUNKRADIX;
+    }
+    return car;
+  }
+  // a[0..n) /= x.  Returns the remainder.
+  static uint64 DivSmall(CT* a, int n, uint64 x) {
+    uint64 car = 0;
+    for (int i = n-1; i >= 0; i--) {
+      car = car*CHUNKRADIX + a[i];
+      a[i] = car/x; car %= x;
+    }
+    return car;
+  }
+  // r[0..n) = a[0..n) << s and a[0..n) >> s, for power-of-two CHUNKRADIX and
+  // 0 <= s < CHUNKBITS.  r may alias a.  ShlSpan returns the chunk shifted out.
+  // Chunks are shifted as uint64, since a[i] << s can overflow a signed CT.
+  static inline uint64 Wide(CT c) {return (typename make_unsigned<CT>::type)c;}
+  static CT ShlSpan(CT* r, const CT* a, int n, int s) {
+    if (!s) {copy(a, a+n, r); return 0;}
+    CT car = Wide(a[n-1]) >> (CHUNKBITS-s);
+    for (int i = n-1; i > 0; i--)
+      r[i] = ((Wide(a[i]) << s) | (Wide(a[i-1]) >> (CHUNKBITS-s))) & (CHUNKRADIX-1);
+    r[0] = (Wide(a[0]) << s) & (CHUNKRADIX-1);
+    return car;
+  }
+  static void ShrSpan(CT* r, const CT* a, int n, int s) {
+    if (!s) {copy(a, a+n, r); return;}
+    for (int i = 0; i < n-1; i++)
+      r[i] = (Wide(a[i]) >> s) | ((Wide(a[i+1]) << (CHUNKBITS-s)) & (CHUNKRADIX-1));
+    r[n-1] = Wide(a[n-1]) >> s;
+  }
+  static int CompareSpan(const CT* a, const CT* b, int n) {
+    for (int i = n-1; i >= 0; i--) if (a[i] != b[i]) return (a[i] < b[i]) ? -1 : 1;
+    return 0;
+  }
+  // r[0..na+nb) = a[0..na) * b[0..nb).
+  static void MulSchool(CT* r, const CT* a, int na, const CT* b, int nb) {
+    fill(r, r+na+nb, 0);
+    for (int j = 0; j < nb; j++) {
+      uint64 car = 0, y = b[j];
+      if (!y) continue;
+      for (int i = 0; i < na; i++) {
+        car += r[i+j] + a[i]*y;
+        r[i+j] = car%CHUNKRADIX; car /= CHUNKRADIX;
+      }
+      r[j+na] = car;
+    }
+  }
+  static inline int ChunkLength(const CT* a, int n) {
+    while (n && !a[n-1]) n--;
+    return n;
+  }
+  // Toom-3 evaluates at 0, 1, 2, 3 and infinity, so every interpolation step
+  // stays non-negative.  p(3) < 13*CHUNKRADIX^k must fit in k+1 chunks.
+  static inline bool UseToom3(int n)
+    {return CHUNKRADIX >= 16 && n >= BIGINT__TOOM3;}
+  // Scratch chunks needed by MulBalanced(n).
+  static size_t MulScratch(int n) {
+    if (n < BIGINT__KARATSUBA) return 0;
+    if (UseToom3(n)) {int k = (n+2)/3; return 12*(k+1) + MulScratch(k+1);}
+    int m = (n+1)/2; return 4*(m+1) + MulScratch(m+1);
+  }
+  static inline bool UseNTT(int na, int nb)
+    {return nb >= BIGINT__NTT && na+nb <= (1<<BIGINT__NTTMAXLOG);}
+  // r[0..na+nb) = a[0..na) * b[0..nb), via three-prime NTT and CRT.  Each
+  // product coefficient is below min(na,nb)*CHUNKRADIX^2 < P1*P2*P3 ~ 2^86.
+  static void MulNTT(CT* r, const CT* a, int na, const CT* b, int nb) {
+    const unsigned P1 = 998244353, P2 = 167772161, P3 = 469762049;
+    int n = 1;
+    while (n < na+nb-1) n <<= 1;
+    vector<unsigned> c1, c2, c3;
+    vector<unsigned> ua(a, a+na), ub(b, b+nb);
+    const unsigned* pb = (a == b && na == nb) ? &ua[0] : &ub[0];  // Lets Multiply() square.
+    NTT<P1, 3>::Multiply(&ua[0], na, pb, nb, n, c1);
+    NTT<P2, 3>::Multiply(&ua[0], na, pb, nb, n, c2);
+    NTT<P3, 3>::Multiply(&ua[0], na, pb, nb, n, c3);
+    uint64 inv12 = ModInv(P1, P2), inv13 = ModInv(P1, P3), inv23 = ModInv(P2, P3);
+    // Coefficient i is x1 + P1*y, y < P2*P3 < 2^57.  For large radices y is
+    // split at CHUNKRADIX so the carry stays within 64 bits.
+    unsigned __int128 wide = 0;
+    uint64 car = 0;
+    for (int i = 0; i < na+nb; i++) {
+      uint64 x1 = 0, y = 0;
+      if (i < na+nb-1) {
+        x1 = c1[i];
+        uint64 x2 = (c2[i] + P2 - x1%P2) * inv12 % P2;
+        uint64 x3 = ((c3[i] + P3 - x1%P3) * inv13 % P3 + P3 - x2) * inv23 % P3;
+        y = x2 + x3*P2;
+      }
+      if (CHUNKRADIX >= (1<<24)) {
+        car += x1 + P1*(y%CHUNKRADIX);
+        r[i] = car%CHUNKRADIX;
+        car = car/CHUNKRADIX + P1*(y/CHUNKRADIX);
+      } else {
+        wide += x1 + (unsigned __int128)y*P1;
+        r[i] = (uint64)(wide%CHUNKRADIX); wide /= CHUNKRADIX;
+      }
+    }
+  }
+  // r[0..2n) = a[0..n) * b[0..n), using Karatsuba, Toom-3 or NTT above
+  // thresholds.
+  static void MulBalanced(CT* r, const CT* a, const CT* b, int n, CT* scratch) {
+    if (n < BIGINT__KARATSUBA) {MulSchool(r, a, n, b, n); return;}
+    if (UseNTT(n, n)) {MulNTT(r, a, n, b, n); return;}
+    if (UseToom3(n)) {
+      int k = (n+2)/3, h = n-2*k, l = 2*k+2;
+      CT *ea = scratch, *eb = ea+3*(k+1), *p = eb+3*(k+1), *sub = p+3*l;
+      for (int x = 1; x <= 3; x++) {
+        CT *ex = ea+(x-1)*(k+1), *fx = eb+(x-1)*(k+1);
+        uint64 cara = 0, carb = 0;
+        for (int i = 0; i < k; i++) {
+          cara += a[i] + (uint64)x*a[k+i] + (i < h ? (uint64)x*x*a[2*k+i] : 0);
+          carb += b[i] + (uint64)x*b[k+i] + (i < h ? (uint64)x*x*b[2*k+i] : 0);
+          ex[i] = cara%CHUNKRADIX; cara /= CHUNKRADIX;
+          fx[i] = carb%CHUNKRADIX; carb /= CHUNKRADIX;
+        }
+        ex[k] = cara; fx[k] = carb;
+        MulBalanced(p+(x-1)*l, ex, fx, k+1, sub);
+      }
+      CT *p1 = p, *p2 = p+l, *p3 = p+2*l, *r4 = r+4*k;
+      MulBalanced(r, a, b, k, sub);
+      MulBalanced(r4, a+2*k, b+2*k, h, sub);
+      fill(r+2*k, r4, 0);
+      // p(x) = r0 + r1*x + r2*x^2 + r3*x^3 + r4*x^4, with each ri >= 0.
+      SubFrom(p1, l, r, 2*k); SubFrom(p1, l, r4, 2*h);
+      SubFrom(p2, l, r, 2*k); SubMulSmall(p2, l, r4, 2*h, 16);
+      SubFrom(p3, l, r, 2*k); SubMulSmall(p3, l, r4, 2*h, 81);
+      DivSmall(p2, l, 2); SubFrom(p2, l, p1, l);      // r2 + 3*r3
+      DivSmall(p3, l, 3); SubFrom(p3, l, p1, l);
+      DivSmall(p3, l, 2); SubFrom(p3, l, p2, l);      // r3
+      SubMulSmall(p2, l, p3, l, 3);                        // r2
+      SubFrom(p1, l, p2, l); SubFrom(p1, l, p3, l);        // r1
+      AddTo(r+k, 2*n-k, p1, ChunkLength(p1, l));
+      AddTo(r+2*k, 2*n-2*k, p2, ChunkLength(p2, l));
+      AddTo(r+3*k, 2*n-3*k, p3, ChunkLength(p3, l));
+      return;
+    }
+    int m = (n+1)/2, h = n-m;
+    CT *sa = scratch, *sb = sa+m+1, *z = sb+m+1, *sub = z+2*m+2;
+    copy(a, a+m, sa); sa[m] = AddTo(sa, m, a+m, h);
+    copy(b, b+m, sb); sb[m] = AddTo(sb, m, b+m, h);
+    MulBalanced(z, sa, sb, m+1, sub);
+    MulBalanced(r, a, b, m, sub);
+    MulBalanced(r+2*m, a+m, b+m, h, sub);
+    SubFrom(z, 2*m+2, r, 2*m);
+    SubFrom(z, 2*m+2, r+2*m, 2*h);
+    AddTo(r+m, 2*n-m, z, ChunkLength(z, 2*m+2));
+  }
+  // r[0..na+nb) = a[0..na) * b[0..nb), na >= nb.
+  static void MulSpan(CT* r, const CT* a, int na, const CT* b, int nb) {
+    if (nb < BIGINT__KARATSUBA) {MulSchool(r, a, na, b, nb); return;}
+    if (UseNTT(na, nb)) {MulNTT(r, a, na, b, nb); return;}
+    vector<CT> scratch(MulScratch(nb) + 2*nb);
+    if (na == nb) {MulBalanced(r, a, b, nb, &scratch[2*nb]); return;}
+    fill(r, r+na+nb, 0);
+    for (int i = 0; i < na; i += nb) {
+      int len = min(nb, na-i);
+      if (len == nb) MulBalanced(&scratch[0], a+i, b, nb, &scratch[2*nb]);
+      else MulSpan(&scratch[0], b, nb, a+i, len);
+      AddTo(r+i, na+nb-i, &scratch[0], len+nb);
+    }
+  }
+
+  // acc += a*b, acc -= a*b and acc += a*x, accumulating straight into acc's
+  // chunks: one schoolbook row per chunk of the shorter factor, or, for
+  // products big enough for fast multiplication, a single scratch product.
+  // acc may alias a or b.
+  static void AddMul(BigInt& acc, const BigInt& a, const BigInt& b) {MulAcc(acc, a, b, false);}
+  static void SubMul(BigInt& acc, const BigInt& a, const BigInt& b) {MulAcc(acc, a, b, true);}
+  static void AddMulSmall(BigInt& acc, const BigInt& a, int x) {
+    if (&acc == &a) {BigInt t(a); AddMulSmall(acc, t, x); return;}
+    if (a.zero() || !x) return;
+    bool pneg = a.neg ^ (x < 0);
+    if (acc.zero()) acc.neg = pneg;
+    uint64 ux = abs((int64)x);
+    int n = a.ch.size()+1;
+    for (uint64 t = ux; t; t /= CHUNKRADIX) n++;
+    n = max<int>(n, acc.ch.size()+1);
+    acc.ch.resize(n, 0);
+    if (pneg == acc.neg) AddMulSmall(&acc.ch[0], n, &a.ch[0], a.ch.size(), ux);
+    else if (SubMulSmall(&acc.ch[0], n, &a.ch[0], a.ch.size(), ux)) acc.Negate();
+    acc.trim();
+  }
+  static void MulAcc(BigInt& acc, const BigInt& a, const BigInt& b, bool sub) {
+    if (&acc == &a) {BigInt t(a); MulAcc(acc, t, b, sub); return;}
+    if (&acc == &b) {BigInt t(b); MulAcc(acc, a, t, sub); return;}
+    if (a.zero() || b.zero()) return;
+    const BigInt& x = (a.ch.size() >= b.ch.size()) ? a : b;
+    const BigInt& y = (a.ch.size() >= b.ch.size()) ? b : a;
+    bool pneg = a.neg ^ b.neg ^ sub;
+    if (acc.zero()) acc.neg = pneg;
+    int nx = x.ch.size(), ny = y.ch.size(), n = max<int>(acc.ch.size(), nx+ny) + 1;
+    acc.ch.resize(n, 0);
+    // Subtracting only ever decreases acc, so it wraps below zero at most once.
+    int wrap = 0;
+    if (ny < BIGINT__KARATSUBA) {
+      for (int j = 0; j < ny; j++) {
+        if (pneg == acc.neg) AddMulSmall(&acc.ch[j], n-j, &x.ch[0], nx, y.ch[j]);
+        else wrap |= SubMulSmall(&acc.ch[j], n-j, &x.ch[0], nx, y.ch[j]);
+      }
+    } else {
+      Chunks p(nx+ny);
+      MulSpan(&p[0], &x.ch[0], nx, &y.ch[0], ny);
+      if (pneg == acc.neg) AddTo(&acc.ch[0], n, &p[0], nx+ny);
+      else wrap = SubFrom(&acc.ch[0], n, &p[0], nx+ny);
+    }
+    if (wrap) acc.Negate();
+    acc.trim();
+  }
+
+  // Division.  Divisors are normalized so that their top chunk is at least
+  // CHUNKRADIX/2.  Short divisors use schoolbook (Knuth D) division, longer
+  // ones Burnikel-Ziegler recursion, and the longest a Newton reciprocal.
+  #define BIGINT__BZ 48
+  #define BIGINT__NEWTON 30000
+
+  // Divides u[0..nu) by v[0..nv), nv >= 2, where the top nv chunks of u are
+  // less than v.  The quotient goes to q[0..nu-nv) and the remainder is left
+  // in u[0..nv), with the rest of u zeroed.
+  static void DivSchool(CT* q, CT* u, int nu, const CT* v, int nv) {
+    uint64 vt = v[nv-1], vs = v[nv-2];
+    for (int j = nu-nv-1; j >= 0; j--) {
+      uint64 num = (uint64)u[j+nv]*CHUNKRADIX + u[j+nv-1];
+      uint64 qh = num/vt, rh = num%vt;
+      while (qh >= CHUNKRADIX || qh*vs > rh*CHUNKRADIX + u[j+nv-2]) {
+        qh--; rh += vt;
+        if (rh >= CHUNKRADIX) break;
+      }
+      if (SubMulSmall(u+j, nv+1, v, nv, qh)) {qh--; AddTo(u+j, nv+1, v, nv);}
+      q[j] = qh;
+    }
+  }
+  // Burnikel-Ziegler: divides a[0..2n) by b[0..n), where a < b*CHUNKRADIX^n.
+  // The quotient goes to q[0..n) and the remainder to a[0..n).
+  static void Div2n1n(CT* q, CT* a, const CT* b, int n) {
+    if ((n&1) || n < BIGINT__BZ) {DivSchool(q, a, 2*n, b, n); return;}
+    int h = n/2;
+    Div3n2n(q+h, a+h, b, h);
+    Div3n2n(q, a, b, h);
+  }
+  // Divides a[0..3h) by b[0..2h), where a < b*CHUNKRADIX^h.  The quotient goes
+  // to q[0..h) and the remainder to a[0..2h).
+  static void Div3n2n(CT* q, CT* a, const CT* b, int h) {
+    if (CompareSpan(a+2*h, b+h, h) < 0) {
+      Div2n1n(q, a+h, b+h, h);
+    } else {  // The top halves are equal, so the quotient is CHUNKRADIX^h-1.
+      fill(q, q+h, CHUNKRADIX-1);
+      fill(a+2*h, a+3*h, 0);
+      AddTo(a+h, 2*h, b+h, h);
+    }
+    vector<CT> d(2*h);
+    MulSpan(&d[0], q, h, b, h);
+    int bor = SubFrom(a, 3*h, &d[0], 2*h);
+    while (bor) {
+      for (int i = 0; i < h; i++) {if (q[i]) {q[i]--; break;} q[i] = CHUNKRADIX-1;}
+      if (AddTo(a, 3*h, b, 2*h)) bor = 0;
+    }
+  }
+  // Divides u[0..nu) by a normalized v[0..nv), nu > nv >= 2, where the top
+  // nv chunks of u are less than v.  Quotient and remainder as DivSchool.
+  static void DivSpan(CT* q, CT* u, int nu, const CT* v, int nv) {
+    if (nv < BIGINT__BZ) {DivSchool(q, u, nu, v, nv); return;}
+    // Pad the divisor to m*2^k chunks, m < BIGINT__BZ, so each recursion
+    // level splits evenly.  Both operands shift by the same amount.
+    int n = nv, k = 0;
+    while (n >= BIGINT__BZ) {n = (n+1)/2; k++;}
+    n <<= k;
+    int sh = n-nv, t = (nu+sh)/n + 1;
+    vector<CT> ub(t*n), vb(n), qb(t*n);
+    copy(u, u+nu, ub.begin()+sh);
+    copy(v, v+nv, vb.begin()+sh);
+    for (int i = t-2; i >= 0; i--) Div2n1n(&qb[i*n], &ub[i*n], &vb[0], n);
+    copy(qb.begin(), qb.begin()+(nu-nv), q);
+    fill(u, u+nu, 0);
+    copy(ub.begin()+sh, ub.begin()+n, u);
+  }
+  // a*CHUNKRADIX^k for k >= 0, or a/CHUNKRADIX^-k (truncated) for k < 0.
+  static BigInt ShiftChunks(const BigInt& a, int k) {
+    BigInt ret;
+    if (k >= 0) {
+      if (a.zero()) return ret;
+      ret.ch.assign(k, (CT)0);
+      ret.ch.insert(ret.ch.end(), a.ch.begin(), a.ch.end());
+    } else if (-k < a.ch.size()) {
+      ret.ch.assign(a.ch.begin()-k, a.ch.end());
+    }
+    ret.neg = a.neg;
+    ret.trim();
+    return ret;
+  }
+  // Returns floor(CHUNKRADIX^(2m) / d), possibly off by a few units, for a
+  // normalized d of m chunks, by a Newton step from the reciprocal of the
+  // top half of d.
+  static BigInt Reciprocal(const BigInt& d) {
+    int m = d.ch.size();
+    BigInt one(1), ret;
+    if (m < BIGINT__NEWTON) {
+      DivMod(ShiftChunks(one, 2*m), d, &ret, NULL);
+      return ret;
+    }
+    int h = m/2+1;
+    BigInt xh = Reciprocal(ShiftChunks(d, h-m));
+    BigInt e = ShiftChunks(one, 2*m) - ShiftChunks(d*xh, m-h);
+    return ShiftChunks(xh, m-h) + ShiftChunks(xh*e, -m-h);
+  }
+  // Divides u (nonnegative) by a normalized v of m chunks, given
+  // x ~ Reciprocal(v), by Barrett reduction of m-chunk blocks from the top.
+  static void DivNewton(const BigInt& u, const BigInt& v, const BigInt& x, BigInt* q, BigInt* r) {
+    int m = v.ch.size(), nu = u.ch.size();
+    BigInt rem, qb, one(1);
+    Chunks qret(max(nu-m+1, 1));
+    for (int top = nu; top > 0; ) {
+      int t = (top-1)%m + 1;
+      top -= t;
+      BigInt num;
+      num.ch.assign(u.ch.begin()+top, u.ch.begin()+top+t);
+      num.ch.insert(num.ch.end(), rem.ch.begin(), rem.ch.end());
+      num.trim();
+      qb = ShiftChunks(ShiftChunks(num, 1-m) * x, -m-1);
+      rem = num - qb*v;
+      while (rem.neg) {rem += v; qb -= one;}
+      while (rem >= v) {rem -= v; qb += one;}
+      for (int i = 0; i < qb.ch.size() && top+i < qret.size(); i++) qret[top+i] = qb.ch[i];
+    }
+    if (q) {q->ch.swap(qret); q->neg = false; q->trim();}
+    if (r) *r = rem;
+  }
+  // Sets *q = a/b (truncated) and *r = a%b (with the sign of a).  Either may
+  // be NULL, and either may alias a or b.  Division by zero gives q = 0, r = a.
+  static void DivMod(const BigInt& a, const BigInt& b, BigInt* q, BigInt* r) {
+    bool qneg = a.neg ^ b.neg, rneg = a.neg;
+    int na = a.ch.size(), nb = b.ch.size();
+    if (b.zero() || na < nb || (na == nb && CompareSpan(&a.ch[0], &b.ch[0], na) < 0)) {
+      if (r) *r = a;
+      if (q) *q = BigInt();
+      return;
+    }
+    BigInt qret, rret;
+    if (nb > 2*(na-nb) + BIGINT__BZ) {
+      // The quotient is much shorter than the divisor, so estimate it from
+      // truncated operands (it is then off by at most 1) and correct.
+      int sh = 2*nb - na - 3;
+      BigInt ua = abs(a), ub = abs(b), one(1);
+      DivMod(ShiftChunks(ua, -sh), ShiftChunks(ub, -sh), &qret, NULL);
+      rret = ua;
+      SubMul(rret, qret, ub);
+      while (rret.neg) {rret += ub; qret -= one;}
+      while (rret >= ub) {rret -= ub; qret += one;}
+    } else if (nb == 1) {
+      qret = a;
+      rret = BigInt((int64)DivSmall(&qret.ch[0], na, b.ch[0]));
+    } else {
+      // Normalize so the divisor's top chunk is at least CHUNKRADIX/2: by a
+      // shift for power-of-two radices, else by a multiplication.
+      uint64 d = CHUNKRADIX/((uint64)b.ch.back()+1);
+      int sh = (CHUNKBITS > 0) ? CHUNKBITS + __builtin_clz((unsigned)b.ch.back()) - 32 : 0;
+      BigInt u, v;
+      u.ch.resize(na+1); v.ch.resize(nb);
+      if (CHUNKBITS > 0) {
+        u.ch[na] = ShlSpan(&u.ch[0], &a.ch[0], na, sh);
+        ShlSpan(&v.ch[0], &b.ch[0], nb, sh);
+      } else {
+        u.ch[na] = MulSmall(&u.ch[0], &a.ch[0], na, d);
+        MulSmall(&v.ch[0], &b.ch[0], nb, d);
+      }
+      if (nb >= BIGINT__NEWTON) {
+        u.trim();
+        DivNewton(u, v, Reciprocal(v), q ? &qret : NULL, &rret);
+      } else {
+        qret.ch.resize(na+1-nb);
+        DivSpan(&qret.ch[0], &u.ch[0], na+1, &v.ch[0], nb);
+        u.ch.resize(nb);
+        rret = u;
+      }
+      if (!rret.zero()) {
+        if (CHUNKBITS > 0) ShrSpan(&rret.ch[0], &rret.ch[0], rret.ch.size(), sh);
+        else DivSmall(&rret.ch[0], rret.ch.size(), d);
+      }
+    }
+    qret.neg = qneg; qret.trim();
+    rret.neg = rneg; rret.trim();
+    if (q) q->ch.swap(qret.ch), q->neg = qret.neg;
+    if (r) r->ch.swap(rret.ch), r->neg = rret.neg;
+  }
+
+  // Montgomery multiplication modulo m[0..n), which must be coprime to
+  // CHUNKRADIX, with minv = -1/m mod CHUNKRADIX: r = a*b/CHUNKRADIX^n mod m
+  // for a, b < m.  Scans the columns of a*b + u*m, picking u[i] so that the
+  // low n columns vanish, so there is no carry chain.  r may alias a or b;
+  // u is scratch space of n chunks.
+  static void MontMul(CT* r, const CT* a, const CT* b, const CT* m, int n, uint64 minv, CT* u) {
+    unsigned __int128 acc = 0;
+    for (int i = 0; i < 2*n-1; i++) {
+      int lo = max(0, i-n+1), hi = min(i, n-1);
+      if (i < n) u[i] = 0;
+      for (int j = lo; j <= hi; ) {
+        uint64 s = 0;  // Up to 8 products below CHUNKRADIX^2 <= 2^60.
+        for (int e = min(hi+1, j+4); j < e; j++) s += (uint64)a[j]*b[i-j] + (uint64)u[j]*m[i-j];
+        acc += s;
+      }
+      if (i < n) {
+        u[i] = (uint64)(acc%CHUNKRADIX)*minv%CHUNKRADIX;
+        acc += (uint64)u[i]*m[0];
+      } else {
+        r[i-n] = acc%CHUNKRADIX;
+      }
+      acc /= CHUNKRADIX;
+    }
+    r[n-1] = acc%CHUNKRADIX;
+    if (acc >= CHUNKRADIX || CompareSpan(r, m, n) >= 0) SubFrom(r, n, m, n);
+  }
+  // Returns -1/x mod CHUNKRADIX, or 0 if x is not invertible.
+  static uint64 MontInverse(uint64 x) {
+    int64 a = x, b = CHUNKRADIX, u = 1, v = 0;
+    while (b) {
+      int64 q = a/b;
+      a -= q*b; swap(a, b);
+      u -= q*v; swap(u, v);
+    }
+    if (a != 1) return 0;
+    u %= CHUNKRADIX;
+    return u ? CHUNKRADIX - (u < 0 ? u+CHUNKRADIX : u) : 0;
+  }
+  // base^exp mod |mod|, in [0, |mod|), for exp >= 0 and mod != 0.  Uses
+  // sliding-window exponentiation, with Montgomery multiplication when mod is
+  // coprime to CHUNKRADIX (e.g. odd for binarybigint).
+  friend BigInt ModPow(const BigInt& base, const BigInt& exp, const BigInt& mod) {
+    BigInt m = abs(mod), one(1), ret;
+    if (m.zero() || m == one) return ret;
+    BigInt<2, (1<<30), 30, unsigned> e(exp);
+    int nbits = e.bit_length(), k = 1;
+    while (k < 6 && nbits > (3*k*(k+1) << k)) k++;
+    auto bit = [&](int i) {return e.test_bit(i);};
+
+    int n = m.ch.size();
+    uint64 minv = MontInverse(m.ch[0]);
+    vector<CT> t(n);
+    auto fix = [&](BigInt x) {  // Into the working representation.
+      x %= m;
+      if (x.neg) x += m;
+      if (!minv) return x;
+      x = ShiftChunks(x, n) % m;
+      x.ch.resize(n);
+      return x;
+    };
+    auto mul = [&](BigInt& x, const BigInt& y) {
+      if (minv) MontMul(&x.ch[0], &x.ch[0], &y.ch[0], &m.ch[0], n, minv, &t[0]);
+      else {x *= y; x %= m;}
+    };
+
+    // Odd powers base^1, base^3, ..., base^(2^k-1).
+    vector<BigInt> pw(1<<(k-1), fix(base));
+    BigInt b2 = pw[0];
+    mul(b2, pw[0]);
+    for (int i = 1; i < pw.size(); i++) {pw[i] = pw[i-1]; mul(pw[i], b2);}
+    bool started = false;
+    for (int i = nbits-1; i >= 0; ) {
+      if (!bit(i)) {
+        if (started) mul(ret, ret);
+        i--;
+        continue;
+      }
+      int j = max(i-k+1, 0), w = 0;
+      while (!bit(j)) j++;
+      for (int l = i; l >= j; l--) {
+        w = 2*w + bit(l);
+        if (started) mul(ret, ret);
+      }
+      if (started) mul(ret, pw[w/2]); else ret = pw[w/2];
+      started = true;
+      i = j-1;
+    }
+    if (!started) return one;
+    if (minv) {
+      BigInt u(one);
+      u.ch.resize(n);
+      mul(ret, u);
+    }
+    ret.trim();
+    return ret;
+  }
+
+  // GCD.  The routines below reduce a >= b >= 0 by unimodular row operations,
+  // which keep the GCD, applying the same operations to k columns of
+  // cofactors r (r[0..k) go with a, r[k..2k) with b).  Lehmer steps work on
+  // the leading 62 bits; above BIGINT__HGCD chunks the half-GCD recursion
+  // reduces the top half first, so the whole GCD costs O(M(n) log n).
+  #define BIGINT__HGCD 150
+
+  // (a, b) = (A*a + B*b, C*a + D*b) in place, for |A|, |B|, |C|, |D| < 2^31
+  // and nonnegative results.
+  static void LinComb(BigInt& a, BigInt& b, int64 A, int64 B, int64 C, int64 D) {
+    int n = a.ch.size();
+    b.ch.resize(n);
+    int64 c1 = 0, c2 = 0;
+    for (int i = 0; i < n; i++) {
+      int64 x = a.ch[i], y = b.ch[i];
+      c1 += A*x + B*y; c2 += C*x + D*y;
+      int64 q1 = c1/CHUNKRADIX, q2 = c2/CHUNKRADIX;
+      c1 -= q1*CHUNKRADIX; c2 -= q2*CHUNKRADIX;
+      if (c1 < 0) {c1 += CHUNKRADIX; q1--;}
+      if (c2 < 0) {c2 += CHUNKRADIX; q2--;}
+      a.ch[i] = c1; b.ch[i] = c2;
+      c1 = q1; c2 = q2;
+    }
+    a.trim(); b.trim();
+  }
+  // Puts a, b into the form a >= b >= 0.
+  static void GcdNormalize(BigInt& a, BigInt& b, BigInt* r, int k) {
+    if (a.neg) {a.neg = false; for (int i = 0; i < k; i++) r[i] = -r[i];}
+    if (b.neg) {b.neg = false; for (int i = k; i < 2*k; i++) r[i] = -r[i];}
+    if (a < b) {a.ch.swap(b.ch); for (int i = 0; i < k; i++) r[i].ch.swap(r[k+i].ch), swap(r[i].neg, r[k+i].neg);}
+  }
+  // One Lehmer step, or a Euclid step if the leading parts don't determine
+  // a quotient.  Requires a >= b > 0.
+  static void GcdStep(BigInt& a, BigInt& b, BigInt* r, int k) {
+    int64 x = 0, y = 0, A = 1, B = 0, C = 0, D = 1, lim = 1LL<<31;
+    for (int i = a.ch.size(); i > 0 && x < (1LL<<62)/CHUNKRADIX; ) {
+      i--;
+      x = x*CHUNKRADIX + a.ch[i];
+      y = y*CHUNKRADIX + (i < b.ch.size() ? b.ch[i] : 0);
+    }
+    while (y+C && y+D) {
+      int64 q = (x+A)/(y+C);
+      if (q != (x+B)/(y+D) || q >= lim) break;
+      int64 nc = A-q*C, nd = B-q*D;
+      if (nc >= lim || nc <= -lim || nd >= lim || nd <= -lim) break;
+      A = C; C = nc; B = D; D = nd;
+      int64 t = x-q*y; x = y; y = t;
+    }
+    if (B == 0) {
+      BigInt q;
+      DivMod(a, b, &q, &a);
+      a.ch.swap(b.ch);
+      for (int i = 0; i < k; i++) {
+        r[i] -= q*r[k+i];
+        r[i].ch.swap(r[k+i].ch); swap(r[i].neg, r[k+i].neg);
+      }
+      return;
+    }
+    LinComb(a, b, A, B, C, D);
+    for (int i = 0; i < k; i++) {
+      BigInt t = r[i]*(int)A + r[k+i]*(int)B;
+      r[k+i] = r[i]*(int)C + r[k+i]*(int)D;
+      r[i].ch.swap(t.ch); r[i].neg = t.neg;
+    }
+  }
+  // r = S*r, for k columns of rows.
+  static void GcdApply(const BigInt* S, BigInt* r, int k) {
+    for (int i = 0; i < k; i++) {
+      BigInt t = S[0]*r[i] + S[1]*r[k+i];
+      r[k+i] = S[2]*r[i] + S[3]*r[k+i];
+      r[i].ch.swap(t.ch); r[i].neg = t.neg;
+    }
+  }
+  // Reduces a >= b >= 0 of n chunks until b has at most n/2+1 chunks.
+  // S[0..4), if not NULL, receives the transformation: new (a, b) =
+  // S*(old a, b).
+  static void HalfGcd(BigInt& a, BigInt& b, BigInt* S) {
+    int n = a.ch.size(), s = n/2+1, p = n/2, k = S ? 2 : 0;
+    if (S) {S[0] = S[3] = BigInt(1); S[1] = S[2] = BigInt();}
+    while (b.ch.size() > s) {
+      int m = a.ch.size()-p;
+      if (m < BIGINT__HGCD || b.ch.size() <= p) {GcdStep(a, b, S, k); continue;}
+      // The top m chunks reduced by about m/2 give the next m/2 chunks of
+      // the Euclidean sequence of (a, b).
+      // Since the top parts are reduced exactly, only the low parts need
+      // multiplying.
+      BigInt ah = ShiftChunks(a, -p), bh = ShiftChunks(b, -p), T[4];
+      int na = a.ch.size();
+      a.ch.resize(p); a.trim();
+      b.ch.resize(p); b.trim();
+      HalfGcd(ah, bh, T);
+      BigInt t = ShiftChunks(ah, p) + T[0]*a + T[1]*b;
+      b = ShiftChunks(bh, p) + T[2]*a + T[3]*b;
+      a.ch.swap(t.ch); a.neg = t.neg;
+      GcdApply(T, S, k);
+      GcdNormalize(a, b, S, k);
+      if (a.ch.size() == na && b.ch.size() > s) GcdStep(a, b, S, k);
+      p = max(2*s - (int)a.ch.size(), 0);
+    }
+  }
+  static void GcdReduce(BigInt& a, BigInt& b, BigInt* r, int k) {
+    GcdNormalize(a, b, r, k);
+    while (!b.zero()) {
+      if (b.ch.size() >= BIGINT__HGCD && 2*b.ch.size() > a.ch.size()+2) {
+        BigInt S[4];
+        HalfGcd(a, b, k ? S : NULL);
+        GcdApply(S, r, k);
+      } else {
+        GcdStep(a, b, r, k);
+      }
+    }
+  }
+  friend BigInt Gcd(const BigInt& a, const BigInt& b) {
+    BigInt x = a, y = b;
+    GcdReduce(x, y, NULL, 0);
+    return x;
+  }
+  BigInt Pow(int e) const {
+    BigInt ret(1), x(*this);
+    for (;;) {if (e&1) ret *= x; if (!(e>>=1)) return ret; x *= x;}
+  }
+
+  // Radix conversion, by divide and conquer over pw[i] = base^(2^i), so it
+  // costs O(M(n) log n).  Other radices are packed into base = radix^d < 2^31.
+  #define BIGINT__CONVERT 32
+
+  // Converts c[0..n), little-endian chunks in radix base, to a BigInt.
+  template<class T>
+  static BigInt FromChunks(const T* c, int n, vector<BigInt>& pw) {
+    if (n <= BIGINT__CONVERT) {
+      BigInt ret;
+      int base = pw[0].toint();
+      for (int i = n-1; i >= 0; i--) {ret *= base; ret += BigInt((int64)c[i]);}
+      return ret;
+    }
+    int i = 0;
+    while ((2<<i) < n) i++;
+    while (pw.size() <= i) pw.push_back(pw.back()*pw.back());
+    return FromChunks(c+(1<<i), n-(1<<i), pw)*pw[i] + FromChunks(c, 1<<i, pw);
+  }
+  // Writes x, 0 <= x < pw[i+1], as 2^(i+1) chunks in radix pw[0] to c.
+  static void ToChunks(const BigInt& x, int i, const vector<BigInt>& pw, int* c) {
+    if (x.ch.size() <= BIGINT__CONVERT) {
+      BigInt y(x);
+      int base = pw[0].toint();
+      for (int j = 0; j < (2<<i); j++) {
+        c[j] = y % base;
+        if (!y.zero()) y /= base;
+      }
+      return;
+    }
+    BigInt hi, lo;
+    DivMod(x, pw[i], &hi, &lo);
+    ToChunks(lo, i-1, pw, c);
+    ToChunks(hi, i-1, pw, c+(1<<i));
+  }
+  // The number of digits in radix that are packed into one conversion chunk.
+  static int RadixBlock(int radix, int& base) {
+    int d = 1;
+    for (base = radix; base <= 0x7fffffff/radix; base *= radix) d++;
+    return d;
+  }
+
   inline BigInt() {neg = false;}
-  inline BigInt(const BigInt& b) {ch = b.ch; neg = b.neg;}
+  BigInt(const BigInt& b) = default;
+  BigInt(BigInt&& b) = default;
+  BigInt& operator=(const BigInt& b) = default;
+  BigInt& operator=(BigInt&& b) = default;
   template<int R, int CR, int CS, class T>
   BigInt(const BigInt<R,CR,CS,T>& b) {
-    if (b.zero()) {*this = BigInt(); return;}
-    neg = false;
-    BigInt p(1);
-    for (int i = 0; i < b.ch.size(); i++) {
-      *this += p*b.ch[i];
-      p *= CR;
-    }
-    neg = b.neg;
+    vector<BigInt> pw(1, BigInt(CR));
+    *this = FromChunks(b.ch.data(), b.ch.size(), pw);
+    neg = b.neg && !zero();
   }
   BigInt(int64 n) {
     if ((neg = (n < 0))) n = -n;
     for (; n; n /= CHUNKRADIX) ch.push_back(n%CHUNKRADIX);
   }
   inline BigInt(int n) {*this = BigInt((int64)n);}
-  BigInt(const char *s) {
+  BigInt(const char *s, int radix = RADIX) {
     const char *it, *it2 = s-1;
     if ((neg = (*s=='-'))) it2++;
-    int x = 0, y = 1, z;
+    int base = CHUNKRADIX, d = (radix == RADIX) ? CHUNKSIZE : RadixBlock(radix, base);
+    int x = 0, y = 1, n = 0, z;
+    vector<int> c;
     for (it = s; *it; it++);
     for (--it; it != it2; --it) {
       z = DIGITS.find(toupper(*it));
-      if (z < 0 || z >= RADIX) {ch.clear(); x = 0; y = 1; continue;}
-      x += y*z; y *= RADIX;
-      if (y == CHUNKRADIX) {ch.push_back(x); x = 0; y = 1;}
+      if (z < 0 || z >= radix) {c.clear(); x = 0; y = 1; n = 0; continue;}
+      x += y*z; y *= radix;
+      if (++n == d) {c.push_back(x); x = 0; y = 1; n = 0;}
+    }
+    if (n) c.push_back(x);
+    if (radix == RADIX) {
+      ch.assign(c.begin(), c.end());
+    } else {
+      vector<BigInt> pw(1, BigInt(base));
+      BigInt r = FromChunks(c.data(), c.size(), pw);
+      ch.swap(r.ch);
     }
-    if (y > 1) ch.push_back(x);
     trim();
   }
-  inline BigInt(const string& s) {*this = BigInt(s.c_str());}
+  inline BigInt(const string& s, int radix = RADIX) {*this = BigInt(s.c_str(), radix);}
+};
+
+// ExtendedGcd and roots live outside BigInt, so that process.exe only
+// pastes them into programs that call them.
+
+// Returns g = Gcd(a, b) >= 0 and sets x, y with a*x + b*y = g, where
+// |x| <= max(|b|/g, 1) and |y| <= |a|/g.
+template<typename T> T ExtendedGcd(const T& a, const T& b, T& x, T& y) {
+  T g = abs(a), h = abs(b), r[2] = {T(1), T()};
+  T::GcdReduce(g, h, r, 1);
+  if (g.zero()) {x = y = T(); return g;}
+  x = r[0];
+  if (!b.zero()) x %= h = abs(b)/g;
+  y = g;
+  T::SubMul(y, abs(a), x);
+  y = b.zero() ? T() : y/abs(b);
+  if (a.neg) x = -x;
+  if (b.neg) y = -y;
+  return g;
+}
+
+// Natural log of a BigInt a > 0, from enough leading chunks for 64
+// significant bits (IsPerfectPower rounds expl() of it to an integer).
+template<typename T> long double BigIntLogApprox(const T& a) {
+  int i = a.ch.size() - 1;
+  long double top = 0;
+  for (; i >= 0 && top < 18446744073709551616.0L; i--) top = top*T::ChunkRadix() + a.ch[i];
+  return logl(top) + (i+1)*logl(T::ChunkRadix());
+}
+
+// floor(a^(1/k)) for a BigInt a >= 0.  Newton's method from above converges
+// to the root from any starting point that is at least that.  The start
+// comes from the root of the top half, recursively, so each level costs
+// O(M(n)).
+template<typename T> T BigIntRootFloor(const T& a, int k) {
+  if (k == 1 || a.zero()) return a;
+  int n = a.ch.size(), h = (n+k-1)/k/2;
+  T x;
+  if (h == 0) {  // The root is a single chunk.
+    x = T((int64)(expl(BigIntLogApprox(a)/k)*(1+1e-12L)) + 2);
+  } else {
+    x = T::ShiftChunks(BigIntRootFloor(T::ShiftChunks(a, -k*h), k) + T(1), h);
+  }
+  for (;;) {
+    T y = a/x.Pow(k-1);
+    T::AddMulSmall(y, x, k-1);
+    y /= k;
+    if (y >= x) return x;
+    // y never drops below the root, so once the steps are small, y^k <= a
+    // settles it more cheaply than another division.
+    if ((x-y).ch.size() <= 1 && y.Pow(k) <= a) return y;
+    x.ch.swap(y.ch);
+  }
+}
+
+// floor(a^(1/k)) for a BigInt a >= 0, k >= 1.  Negative a with odd k gives
+// -Root(-a, k); with even k, 0.
+template<typename T> T Root(const T& a, int k) {
+  if (!a.neg) return BigIntRootFloor(a, k);
+  return (k%2) ? -BigIntRootFloor(-a, k) : T();
+}
+
+template<typename T> T Sqrt(const T& a) {return Root(a, 2);}
+
+// BigInt x mod q[i] for lo <= i < hi, through a remainder tree.
+template<typename T> struct BigIntRemainderTree {
+  static T Product(const vector<int>& q, int lo, int hi) {
+    if (hi-lo == 1) return T(q[lo]);
+    return Product(q, lo, (lo+hi)/2) * Product(q, (lo+hi)/2, hi);
+  }
+  static void Residues(const T& x, const vector<int>& q, int lo, int hi, vector<int>& res) {
+    if (hi-lo <= 32) {
+      for (int i = lo; i < hi; i++) res[i] = x%q[i];
+      return;
+    }
+    int mid = (lo+hi)/2;
+    Residues(x % Product(q, lo, mid), q, lo, mid, res);
+    Residues(x % Product(q, mid, hi), q, mid, hi, res);
+  }
 };
 
+// Whether a BigInt a = r^k for some k >= 2.  If so, sets *root and *k for
+// the largest such k.  Each prime exponent p is first screened by a
+// floating-point estimate (small roots) or by p-th power residues modulo
+// primes q = 1 (mod p), so only likely candidates pay for a full Root().
+template<typename T> bool IsPerfectPower(const T& a, T* root = NULL, int* k = NULL) {
+  T m = abs(a), one(1);
+  if (m <= one) {
+    if (root) *root = a;
+    if (k) *k = a.neg ? 3 : 2;
+    return true;
+  }
+  long double la = BigIntLogApprox(m);
+  int bits = la/logl(2) + 1;
+  vector<int> ps, qs, res;
+  for (int p = 2; p <= bits; p++)
+    if (IsPrimeFast(p) && !(a.neg && p == 2)) ps.push_back(p);
+  for (int i = 0; i < ps.size() && bits/ps[i] > 20; i++)
+  for (int q = ps[i]+1, t = (ps[i] < 10) ? 6 : 2; t; q += ps[i])
+    if (IsPrimeFast(q)) {qs.push_back(q); t--;}
+  res.resize(qs.size());
+  if (qs.size()) BigIntRemainderTree<T>::Residues(m, qs, 0, qs.size(), res);
+  for (int i = 0, j = 0; i < ps.size(); i++) {
+    int p = ps[i];
+    T r;
+    if (bits/p <= 20) {
+      long double est = expl(la/p);
+      int64 c = llroundl(est);
+      if (fabsl(est-c) > 1e-6L) continue;
+      r = T(c);
+    } else {
+      bool ok = true;
+      for (int t = (p < 10) ? 6 : 2; t; t--, j++)
+        ok = ok && (!res[j] || ModPow(res[j], (qs[j]-1)/p, qs[j]) == 1);
+      if (!ok) continue;
+      r = BigIntRootFloor(m, p);
+    }
+    if (r.Pow(p) != m) continue;
+    int e = 1;
+    if (a.neg) r = -r;
+    IsPerfectPower(r, &r, &e);
+    if (root) *root = r;
+    if (k) *k = p*e;
+    return true;
+  }
+  return false;
+}
+
 typedef BigInt<10, 1000000000, 9, int> bigint;
 typedef BigInt<2, (1LL<<30), 30, unsigned> binarybigint;
 typedef BigInt<16, (1<<28), 7, int> hexbigint;